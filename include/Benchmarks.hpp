@@ -0,0 +1,38 @@
+/* =====================================================================
+Micro-benchmarks for the core data structures and algorithms
+- Routing: settled nodes and query time per search mode on synthetic grids
+- Hash table: chaining vs incremental rehash vs open addressing (insert/find/remove)
+- Rehash: per-insert latency percentiles while a table grows
+- Heap: push/pop of indexed d-ary and compact queues vs std::priority_queue
+- Stream: traffic-update ingestion throughput and apply latency under load
+Run with: SmartCity --bench [name] [size]
+===================================================================== */
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <string>
+
+class Benchmarks {
+public:
+    // Run one benchmark by name, or all of them for "all"; false if unknown.
+    // size > 0 overrides the benchmark's default problem size.
+    static bool run(const std::string& name, int size = 0);
+
+    // Dijkstra vs bidirectional Dijkstra vs A* on a gridSize x gridSize road grid
+    static void routingBenchmark(int gridSize, int queries);
+
+    // Chained vs open-addressing HashTable with `entries` integer keys
+    static void hashTableBenchmark(int entries);
+
+    // Insert tail latency (resize spikes) for each HashTable policy
+    static void rehashLatencyBenchmark(int entries);
+
+    // Indexed PriorityQueue layouts vs std::priority_queue, `elements` pushes then pops
+    static void priorityQueueBenchmark(int elements);
+
+    // Streamed weight updates applied in batches while A* queries run
+    static void trafficStreamBenchmark(int updates);
+};
+
+#endif // BENCHMARKS_HPP
@@ -0,0 +1,168 @@
+/* =====================================================================
+Binary city snapshot for fast startup
+- One versioned file holds what the CSV loaders and the graph build
+  produce: location / vehicle / delivery / traffic / road records, the
+  location index with its interned name table, the frozen CSR graph
+  arrays with the road-ID index, the QuadTree nodes, the registry slot
+  layouts and the deadline BST shape
+- Layout: header, source stamps, section table, then the sections, each
+  8-byte aligned. Records are fixed-size; their strings are
+  (offset, length) references into one shared string table
+- SnapshotReader maps the file (MappedFile) and copies arrays straight
+  out of the mapping: nothing is parsed or re-derived
+- The header stamps the size and modification time of every source CSV;
+  a snapshot whose sources changed since it was written is stale
+===================================================================== */
+
+#ifndef CITYSNAPSHOT_HPP
+#define CITYSNAPSHOT_HPP
+
+#include "Utils.hpp"
+#include "CsvReader.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+enum class SnapshotSection : uint32_t {
+    Strings = 1,
+    Locations,
+    Vehicles,
+    Deliveries,
+    TrafficEvents,
+    Roads,
+    IndexIds,             // LocationIndex: index -> location ID
+    IndexNames,           // LocationIndex: index -> name
+    IndexNameSlots,       // LocationIndex: linear-probing name table
+    GraphOffsets,         // RoadNetwork CSR arrays
+    GraphTargets,
+    GraphWeights,
+    GraphDistances,
+    GraphCongestions,
+    GraphTimes,
+    GraphReverseOffsets,
+    GraphReverseSources,
+    GraphReverseEdges,
+    ProfileOffsets,
+    ProfileTimes,
+    ProfileWeights,
+    GraphScalars,         // heuristic scales and profile count
+    QuadTreeNodes,        // QuadTree node array
+    QuadTreeEntries,      // leaf blocks: entry count, location indices
+    GraphRoadSlots,       // RoadNetwork: road ID -> edge slot
+    LocationRegistry,     // ConcurrentHashTable slot layouts: record per slot
+    VehicleRegistry,
+    DeliveryRegistry,
+    TrafficRegistry,
+    DeadlineTree          // BST node shape over the delivery records
+};
+
+// String stored in the snapshot's string table
+struct StrRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Size and modification time of a source file when the snapshot was written
+struct SourceStamp {
+    uint64_t size;
+    int64_t modified;
+
+    bool operator==(const SourceStamp& other) const {
+        return size == other.size && modified == other.modified;
+    }
+};
+
+// ==================== Snapshot Writer ====================
+class SnapshotWriter {
+private:
+    std::string strings;
+    bool stringsOverflow = false;    // a string did not fit the 32-bit StrRef offsets
+    std::vector<std::pair<SnapshotSection, std::string>> sections;
+
+public:
+    // Append a string to the string table
+    StrRef addString(std::string_view text);
+
+    // Raw section bytes (copied; padded to 8 bytes when saved)
+    void addSection(SnapshotSection id, const void* data, size_t bytes);
+
+    template<typename T>
+    void addArray(SnapshotSection id, const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot arrays hold plain data");
+        addSection(id, values.data(), values.size() * sizeof(T));
+    }
+
+    // Record sections for the loaded data
+    void add(const std::vector<Location>& locations);
+    void add(const std::vector<Vehicle>& vehicles);
+    void add(const std::vector<Delivery>& deliveries);
+    void add(const std::vector<TrafficEvent>& events);
+    void add(const std::vector<Edge>& roads);
+
+    // Write header, stamps, section table and sections; false on I/O error
+    // or when the string table outgrew StrRef's 32-bit offsets
+    bool save(const std::string& path, const std::vector<SourceStamp>& sources) const;
+};
+
+// ==================== Snapshot Reader ====================
+class SnapshotReader {
+private:
+    MappedFile file;
+    std::vector<std::pair<SnapshotSection, std::string_view>> sections;
+    std::string_view strings;
+
+public:
+    // Map a snapshot and check its header; false if missing, corrupt, of
+    // another format version, or written from different source files
+    bool open(const std::string& path, const std::vector<SourceStamp>& sources);
+    void close();
+
+    // Section bytes (empty view if absent)
+    std::string_view section(SnapshotSection id) const;
+
+    // Copy an array section; false if absent or not a whole number of T
+    template<typename T>
+    bool readArray(SnapshotSection id, std::vector<T>& values) const {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot arrays hold plain data");
+        std::string_view bytes = section(id);
+        if (bytes.data() == nullptr || bytes.size() % sizeof(T) != 0) return false;
+        values.resize(bytes.size() / sizeof(T));
+        if (!values.empty()) std::memcpy(values.data(), bytes.data(), bytes.size());
+        return true;
+    }
+
+    // Array section read in place from the mapping (sections are 8-byte
+    // aligned); nullptr if absent or not a whole number of T
+    template<typename T>
+    const T* view(SnapshotSection id, size_t& count) const {
+        static_assert(std::is_trivially_copyable<T>::value && alignof(T) <= 8,
+                      "snapshot arrays hold plain data");
+        std::string_view bytes = section(id);
+        if (bytes.data() == nullptr || bytes.size() % sizeof(T) != 0 ||
+            reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) != 0) {
+            return nullptr;
+        }
+        count = bytes.size() / sizeof(T);
+        return reinterpret_cast<const T*>(bytes.data());
+    }
+
+    // String table entry; false if the reference is out of bounds
+    bool string(const StrRef& ref, std::string& text) const;
+
+    // Record sections back into the system's structs
+    bool read(std::vector<Location>& locations) const;
+    bool read(std::vector<Vehicle>& vehicles) const;
+    bool read(std::vector<Delivery>& deliveries) const;
+    bool read(std::vector<TrafficEvent>& events) const;
+    bool read(std::vector<Edge>& roads) const;
+
+    size_t fileSize() const;
+};
+
+// Current stamps of the files a snapshot is derived from (0/0 if missing)
+std::vector<SourceStamp> stampSourceFiles(const std::vector<std::string>& paths);
+
+#endif // CITYSNAPSHOT_HPP
@@ -0,0 +1,239 @@
+/* =======================================================================
+Thread-safe hash table for registries shared between worker threads
+o Keys are spread over independent shards, each one a HashTable guarded
+  by its own reader-writer lock, so threads touching different shards
+  never wait on each other
+o Lookups take the shard lock shared, writes take it exclusively
+o Compound operations (update, upsert) run the caller's function on the
+  stored value under the shard lock, so a read-modify-write is atomic
+o Values are only handed out as copies or inside a callback; a pointer
+  into a shard would outlive its lock
+Reads are not optimistic (seqlock style): values such as strings and
+vectors cannot be copied safely while a writer may be changing them.
+======================================================================= */
+
+#ifndef CONCURRENTHASHTABLE_HPP
+#define CONCURRENTHASHTABLE_HPP
+
+#include "HashTable.hpp"
+#include <shared_mutex>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+template<typename K, typename V, typename Policy = OpenAddressing>
+class ConcurrentHashTable {
+private:
+    // One lock per shard, on its own cache line so shards do not false-share
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        HashTable<K, V, Policy> table;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask;
+    static const size_t DEFAULT_SHARDS = 16;
+
+    // Mix the key hash before taking low bits, the inner tables index with
+    // the raw hash and must still see every bucket within a shard
+    template<typename Q>
+    Shard& shardFor(const Q& key) const {
+        uint64_t h = TableHash<K>()(key);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return shards[(h ^ (h >> 31)) & shardMask];
+    }
+
+public:
+    // shardCount is rounded up to a power of two
+    explicit ConcurrentHashTable(size_t shardCount = DEFAULT_SHARDS) {
+        size_t count = 1;
+        while (count < shardCount) count <<= 1;
+        shards.reset(new Shard[count]);
+        shardMask = count - 1;
+    }
+
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    // Insert or overwrite a key-value pair
+    void insert(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(shard.lock);
+        shard.table.insert(key, value);
+    }
+
+    // Insert or overwrite, moving the value in; true if the key was new
+    bool insert_or_assign(const K& key, V&& value) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(shard.lock);
+        return shard.table.insert_or_assign(key, std::move(value)).second;
+    }
+
+    // Copy the value out
+    template<typename Q>
+    bool find(const Q& key, V& value) const {
+        Shard& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(shard.lock);
+        return shard.table.find(key, value);
+    }
+
+    // Run fn(const V&) under the shared lock; false if the key is absent
+    template<typename Q, typename F>
+    bool read(const Q& key, F&& fn) const {
+        Shard& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(shard.lock);
+        const V* value = static_cast<const HashTable<K, V, Policy>&>(shard.table).findPtr(key);
+        if (!value) return false;
+        fn(*value);
+        return true;
+    }
+
+    // Atomically modify an existing value with fn(V&); false if absent
+    template<typename Q, typename F>
+    bool update(const Q& key, F&& fn) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(shard.lock);
+        V* value = shard.table.findPtr(key);
+        if (!value) return false;
+        fn(*value);
+        return true;
+    }
+
+    // Atomically modify the value, default-constructing it first if the key
+    // is absent; true if it was inserted
+    template<typename F>
+    bool upsert(const K& key, F&& fn) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(shard.lock);
+        auto result = shard.table.try_emplace(key);
+        fn(*result.first);
+        return result.second;
+    }
+
+    template<typename Q>
+    bool remove(const Q& key) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(shard.lock);
+        return shard.table.remove(key);
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        Shard& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(shard.lock);
+        return shard.table.contains(key);
+    }
+
+    // Sum over shards; only a snapshot while writers are active
+    int size() const {
+        int total = 0;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            total += shards[i].table.size();
+        }
+        return total;
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+            shards[i].table.clear();
+        }
+    }
+
+    std::vector<K> getAllKeys() const {
+        std::vector<K> keys;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            std::vector<K> part = shards[i].table.getAllKeys();
+            keys.insert(keys.end(), part.begin(), part.end());
+        }
+        return keys;
+    }
+
+    std::vector<V> getAllValues() const {
+        std::vector<V> values;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            std::vector<V> part = shards[i].table.getAllValues();
+            values.insert(values.end(), part.begin(), part.end());
+        }
+        return values;
+    }
+
+    // Snapshot layout: the shard count, then per shard its slot count and
+    // each slot's record index (-1 if empty), as named by recordOf(key);
+    // empty if recordOf does not know a key (returns -1)
+    template<typename F>
+    std::vector<int32_t> layout(F&& recordOf) const {
+        std::vector<int32_t> result{static_cast<int32_t>(shardMask + 1)};
+        bool complete = true;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            size_t base = result.size() + 1;
+            result.push_back(static_cast<int32_t>(shards[i].table.slotCount()));
+            result.resize(base + shards[i].table.slotCount(), -1);
+            shards[i].table.forEachSlot([&](size_t slot, const K& key) {
+                int record = recordOf(key);
+                if (record < 0) complete = false;
+                result[base + slot] = record;
+            });
+        }
+        if (!complete) result.clear();
+        return result;
+    }
+
+    // Refill every shard from layout(); entryAt(record) builds the key-value
+    // pair of a record. False (table left empty) if the layout was written
+    // with another shard count or a key is not where a lookup finds it
+    template<typename F>
+    bool restoreLayout(const std::vector<int32_t>& saved, size_t recordCount, F&& entryAt) {
+        if (saved.empty() || saved[0] != static_cast<int32_t>(shardMask + 1)) return false;
+        size_t pos = 1;
+        bool valid = true;
+        for (size_t i = 0; i <= shardMask && valid; i++) {
+            std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+            if (pos >= saved.size() || saved[pos] < 0 ||
+                static_cast<size_t>(saved[pos]) > saved.size() - pos - 1) {
+                valid = false;
+                break;
+            }
+            size_t count = saved[pos];
+            valid = shards[i].table.restoreSlots(saved.data() + pos + 1, count, recordCount, entryAt);
+            pos += count + 1;
+            // Each key must also sit in the shard its hash selects
+            shards[i].table.forEachSlot([&](size_t, const K& key) {
+                if (&shardFor(key) != &shards[i]) valid = false;
+            });
+        }
+        if (!valid || pos != saved.size()) {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    void printStatistics() const {
+        int smallest = -1, largest = 0, total = 0;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+            int count = shards[i].table.size();
+            total += count;
+            largest = std::max(largest, count);
+            smallest = (smallest < 0) ? count : std::min(smallest, count);
+        }
+        std::cout << "Concurrent Hash Table Statistics:\n";
+        std::cout << "  Shards: " << shardMask + 1 << "\n";
+        std::cout << "  Load Count: " << total << "\n";
+        std::cout << "  Shard Entries (min/max): " << smallest << "/" << largest << "\n";
+    }
+};
+
+#endif // CONCURRENTHASHTABLE_HPP
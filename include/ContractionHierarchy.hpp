@@ -0,0 +1,83 @@
+/* =====================================================================
+Contraction Hierarchies (CH) for fast point-to-point routing
+- Preprocessing: contract nodes in importance order (edge difference),
+  adding shortcuts only where no witness path exists
+- Query: bidirectional Dijkstra that only relaxes edges towards
+  higher-ranked nodes, then unpacks shortcuts into road-level paths
+- Many-to-many: bucket-based distance tables from upward searches
+- Serialization: binary file keyed by the road network fingerprint so
+  preprocessing is not repeated at every startup
+===================================================================== */
+
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include "Network.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class ContractionHierarchy {
+private:
+    // Arc in the search graph; middle == -1 for an original road
+    struct Arc {
+        int node;
+        double weight;
+        int middle;
+    };
+
+    const RoadNetwork* network;
+    uint64_t networkFingerprint;
+    uint64_t networkVersion;             // graph version the hierarchy matches
+    int shortcutCount;
+
+    std::vector<int> rank;               // [index] -> contraction order
+
+    // Upward graphs in CSR form
+    std::vector<int> forwardOffsets;     // u -> higher-ranked v along u -> v
+    std::vector<Arc> forwardArcs;
+    std::vector<int> backwardOffsets;    // v -> higher-ranked u along u -> v
+    std::vector<Arc> backwardArcs;
+
+    static const int WITNESS_SETTLE_LIMIT = 500;
+    static const uint32_t FILE_MAGIC = 0x48434353;   // "SCCH"
+    static const uint32_t FILE_VERSION = 2;
+
+    // Middle node of the stored arc u -> v (-1 if original)
+    int findMiddle(int u, int v) const;
+
+    // Expand arc u -> v into road-level nodes, appending everything after u
+    void unpackArc(int u, int v, int middle, std::vector<int>& path) const;
+
+    // Complete upward search from start; visit(node, distance) per settled node
+    template<typename Visitor>
+    void upwardSearch(int start, bool forward, std::vector<double>& dist,
+                      std::vector<int>& touched, Visitor visit) const;
+
+public:
+    ContractionHierarchy();
+
+    // Offline preprocessing over the frozen road network
+    void build(const RoadNetwork& roadNetwork);
+
+    // Persist / restore the preprocessed hierarchy; load fails if the file
+    // was built for a different graph
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, const RoadNetwork& roadNetwork);
+
+    // True when built for the network's current topology and weights (O(1))
+    bool isValidFor(const RoadNetwork& roadNetwork) const;
+    bool isBuilt() const;
+    int getShortcutCount() const;
+
+    // Bidirectional upward search; same paths as RoadNetwork::shortestPath
+    std::vector<int> shortestPathIndices(int src, int dest, SearchStats* stats = nullptr) const;
+    std::vector<int> shortestPath(int source, int destination, SearchStats* stats = nullptr) const;
+
+    // Bucket many-to-many: one backward search per target fills buckets,
+    // one forward search per source scans them (dense indices, -1 skipped)
+    void fillDistanceMatrix(const std::vector<int>& sources, const std::vector<int>& destinations,
+                            DistanceMatrix& matrix) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_HPP
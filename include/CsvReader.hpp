@@ -0,0 +1,71 @@
+/* =====================================================================
+Zero-copy CSV ingestion for the data loaders
+- MappedFile: maps a whole file read-only (mmap); on platforms without
+  mmap the file is read into one buffer instead
+- CsvReader: walks the bytes row by row, handing out fields as
+  std::string_view spans over the mapping (no per-line or per-field
+  allocation); delimiters are found with memchr
+- Numbers are parsed with std::from_chars straight from the spans
+Quoted fields are not supported, like the original line parser.
+===================================================================== */
+
+#ifndef CSVREADER_HPP
+#define CSVREADER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+class MappedFile {
+private:
+    const char* bytes;
+    size_t length;
+    bool mapped;             // bytes come from mmap (else from buffer)
+    std::string buffer;      // fallback storage
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map a file, replacing any previous one; false if it cannot be read
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    std::string_view data() const;
+};
+
+class CsvReader {
+private:
+    std::string_view text;
+    size_t position;
+    std::string_view row;    // last row returned, without the line break
+    long long rowNumber;
+
+public:
+    explicit CsvReader(std::string_view text);
+
+    // Split the next row into trimmed fields; false at the end of the text.
+    // Blank rows come back as a single empty field.
+    bool nextRow(std::vector<std::string_view>& fields);
+
+    // Raw text and 1-based number of the last row (for error messages)
+    std::string_view line() const;
+    long long lineNumber() const;
+
+    // Number of rows in a text (line breaks, plus an unterminated last row)
+    static size_t countRows(std::string_view text);
+
+    // Trim blanks (spaces, tabs, line breaks, other control bytes) from both ends
+    static std::string_view trim(std::string_view field);
+
+    // Whole-field numeric parsing; false on empty, malformed or trailing input
+    static bool parseInt(std::string_view field, int& value);
+    static bool parseDouble(std::string_view field, double& value);
+};
+
+#endif // CSVREADER_HPP
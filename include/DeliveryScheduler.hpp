@@ -12,103 +12,18 @@ Responsibilities:
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <string_view>
 #include "Utils.hpp"
 #include "HashTable.hpp"
+#include "PriorityQueue.hpp"
+#include "ConcurrentHashTable.hpp"
 #include "SpatialIndex.hpp"
 #include "Network.hpp"
-
-// ==================== Priority Queue Template ====================
-template<typename T> 
-class PriorityQueue { 
-private:
-    std::vector<T> heap; 
-    std::function<bool(const T&, const T&)> comparator; 
-    
-    // Restore heap property by moving element up
-    void heapifyUp(int index) { 
-        while (index > 0) {
-            int parent = (index - 1) / 2;
-            if (comparator(heap[index], heap[parent])) {
-                std::swap(heap[index], heap[parent]);
-                index = parent;
-            } else {
-                break;
-            }
-        }
-    }
-    
-    // Restore heap property by moving element down
-    void heapifyDown(int index) { 
-        int size = heap.size();
-        while (2 * index + 1 < size) {
-            int smallest = index;
-            int left = 2 * index + 1;
-            int right = 2 * index + 2;
-            
-            if (left < size && comparator(heap[left], heap[smallest])) {
-                smallest = left;
-            }
-            if (right < size && comparator(heap[right], heap[smallest])) {
-                smallest = right;
-            }
-            
-            if (smallest != index) {
-                std::swap(heap[index], heap[smallest]);
-                index = smallest;
-            } else {
-                break;
-            }
-        }
-    }
-
-public:
-    // Constructor with comparator
-    PriorityQueue(std::function<bool(const T&, const T&)> cmp) 
-        : comparator(cmp) {}
-    
-    // Insert element into priority queue
-    void push(const T& element) {
-        heap.push_back(element);
-        heapifyUp(heap.size() - 1);
-    }
-    
-    // Remove and return the top (highest priority) element
-    T pop() {
-        if (heap.empty()) {
-            throw std::runtime_error("Priority queue is empty");
-        }
-        T top = heap[0];
-        heap[0] = heap.back();
-        heap.pop_back();
-        if (!heap.empty()) {
-            heapifyDown(0);
-        }
-        return top;
-    }
-    
-    // Return top element without removing
-    const T& top() const {
-        if (heap.empty()) {
-            throw std::runtime_error("Priority queue is empty");
-        }
-        return heap[0];
-    }
-    
-    // Check if queue is empty
-    bool empty() const {
-        return heap.empty();
-    }
-    
-    // Get size of queue
-    int size() const {
-        return heap.size();
-    }
-    
-    // Clear all elements
-    void clear() {
-        heap.clear();
-    }
-};
+#include "ContractionHierarchy.hpp"
+#include "ThreadPool.hpp"
 
 // ==================== Delivery Assignment Record ====================
 struct DeliveryAssignment {
@@ -121,17 +36,78 @@ struct DeliveryAssignment {
     DeliveryAssignment() : vehicleId(0), estimatedTime(0.0) {}
 };
 
+// ==================== Route Cache ====================
+// Bounded LRU of computed routes keyed by (source, destination, weight
+// profile). All entries are dropped once the road network version moves.
+struct RouteCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    long long invalidations = 0;
+};
+
+class RouteCache {
+private:
+    struct Key {
+        int source;
+        int destination;
+        int profile;
+        bool operator==(const Key& other) const {
+            return source == other.source && destination == other.destination &&
+                   profile == other.profile;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(k.source)) << 32) ^
+                         static_cast<uint32_t>(k.destination);
+            return std::hash<uint64_t>()(h * 31 + static_cast<uint32_t>(k.profile));
+        }
+    };
+    struct Entry {
+        Key key;
+        std::vector<int> route;
+    };
+    
+    size_t capacity;
+    uint64_t graphVersion;
+    std::list<Entry> entries;   // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup;
+    RouteCacheStats stats;
+    
+    // Drop everything computed against an older graph
+    void syncVersion(uint64_t version);
+
+public:
+    explicit RouteCache(size_t capacity);
+    
+    bool get(int source, int destination, int profile, uint64_t version, std::vector<int>& route);
+    void put(int source, int destination, int profile, uint64_t version, const std::vector<int>& route);
+    void clear();
+    size_t size() const;
+    const RouteCacheStats& getStats() const;
+};
+
+// ==================== Delivery Order ====================
+// Scheduling key: higher priority first, then earlier deadline
+struct DeliveryUrgency {
+    uint64_t operator()(const Delivery& delivery) const {
+        return delivery.urgencyKey();
+    }
+};
+
 // ==================== Delivery Scheduler Class ====================
 class DeliveryScheduler {
 private:
-    // Priority queue for pending deliveries
-    PriorityQueue<Delivery> pendingDeliveries;
+    // Priority queue for pending deliveries, indexed by delivery ID; the heap
+    // only holds packed urgency keys, deliveries stay in place
+    CompactPriorityQueue<std::string, Delivery, DeliveryUrgency> pendingDeliveries;
     
-    // Hash table to track assigned deliveries
-    HashTable<std::string, DeliveryAssignment> assignedDeliveries;
+    // Hash table to track assigned deliveries (safe to share across threads)
+    ConcurrentHashTable<std::string, DeliveryAssignment> assignedDeliveries;
     
-    // Hash table for vehicle assignments
-    HashTable<int, std::vector<std::string>> vehicleDeliveries;
+    // Hash table for vehicle assignments (safe to share across threads)
+    ConcurrentHashTable<int, std::vector<std::string>> vehicleDeliveries;
     
     // Reference to road network for pathfinding
     RoadNetwork* roadNetwork;
@@ -139,21 +115,11 @@ private:
     // Reference to spatial index for nearest location queries
     QuadTree* spatialIndex;
     
-    // Priority comparator
-    static bool compareDeliveries(const Delivery& d1, const Delivery& d2) {
-        // Priority levels: "High" > "Medium" > "Low"
-        auto getPriorityLevel = [](const std::string& p) -> int {
-            if (p == "High") return 3;
-            if (p == "Medium") return 2;
-            return 1;  // Low
-        };
-        
-        int p1 = getPriorityLevel(d1.priority);
-        int p2 = getPriorityLevel(d2.priority);
-        
-        if (p1 != p2) return p1 > p2;
-        return d1.deadline < d2.deadline;  // Earlier deadline has higher priority
-    }
+    // Optional preprocessed hierarchy for fast point-to-point queries
+    const ContractionHierarchy* hierarchy;
+    
+    // Recently computed routes, invalidated by graph changes
+    RouteCache routeCache;
     
     // Check if vehicle has capacity for delivery
     bool hasCapacity(const Vehicle& vehicle, const Delivery& delivery) const {
@@ -162,43 +128,93 @@ private:
     
     // Calculate estimated delivery time
     double calculateEstimatedTime(const std::vector<int>& route);
+    
+    // Location IDs of a delivery's endpoints (-1 if unknown)
+    int sourceOf(const Delivery& delivery, const std::vector<Location>& locations) const;
+    int destinationOf(const Delivery& delivery, const std::vector<Location>& locations) const;
+    
+    // Shared assignment path; precomputed == nullptr routes on the spot
+    bool assignWithRoute(const std::string& deliveryId, int vehicleId,
+                         const std::vector<Vehicle>& vehicles,
+                         const std::vector<Location>& locations,
+                         const std::vector<int>* precomputed);
 
 public:
     // Constructor
-    DeliveryScheduler(RoadNetwork* network, QuadTree* spatial)
-        : pendingDeliveries(compareDeliveries), roadNetwork(network), spatialIndex(spatial) {}
+    DeliveryScheduler(RoadNetwork* network, QuadTree* spatial, size_t routeCacheCapacity = 4096)
+        : roadNetwork(network), spatialIndex(spatial),
+          hierarchy(nullptr), routeCache(routeCacheCapacity) {}
+    
+    // Route through a contraction hierarchy instead of A* (nullptr to disable)
+    void setContractionHierarchy(const ContractionHierarchy* ch);
     
-    // Add new delivery to queue
+    // Add new delivery to queue (a queued ID is reprioritized instead)
     void addDelivery(const Delivery& delivery);
     
+    // Queue many deliveries without per-delivery output; returns how many were new
+    int addDeliveries(const std::vector<Delivery>& deliveries);
+    
     // Get next highest priority delivery
     Delivery getNextDelivery();
     
-    // Assign delivery to vehicle
+    // Assign any pending delivery to a vehicle; it leaves the queue on success
     bool assignDeliveryToVehicle(const std::string& deliveryId, int vehicleId, 
                                   const std::vector<Vehicle>& vehicles,
                                   const std::vector<Location>& locations);
     
-    // Get route for a delivery (find optimal path)
+    // Assign delivery to vehicle with a route computed beforehand
+    bool assignDeliveryToVehicle(const std::string& deliveryId, int vehicleId,
+                                  const std::vector<Vehicle>& vehicles,
+                                  const std::vector<Location>& locations,
+                                  const std::vector<int>& route);
+    
+    // Get route for a delivery (find optimal path) under a weight profile;
+    // only the balanced profile can use the hierarchy
     std::vector<int> calculateOptimalRoute(const std::string& source, 
                                            const std::string& destination,
-                                           const std::vector<Location>& locations);
-    
-    // Reassign delivery (handles priority changes)
+                                           const std::vector<Location>& locations,
+                                           const WeightProfile& profile = WeightProfile::balanced());
+    
+    // Same, between location IDs
+    std::vector<int> calculateOptimalRoute(int sourceId, int destId,
+                                           const WeightProfile& profile = WeightProfile::balanced());
+    
+    // Routes for many deliveries at once: cache hits are served directly, the
+    // misses are searched in parallel on the pool and then cached.
+    // Result i is the source -> destination route of deliveries[i].
+    std::vector<std::vector<int>> calculateOptimalRoutes(const std::vector<Delivery>& deliveries,
+                                                         const std::vector<Location>& locations,
+                                                         ThreadPool& pool,
+                                                         const WeightProfile& profile = WeightProfile::balanced());
+    
+    // Match each delivery to the closest free vehicle with enough capacity,
+    // using one vehicle-start x delivery-source cost matrix (-1 if none)
+    std::vector<int> matchVehicles(const std::vector<Delivery>& deliveries,
+                                   const std::vector<Vehicle>& vehicles,
+                                   const std::vector<Location>& locations);
+    
+    // Reassign delivery (handles priority changes): a pending delivery is
+    // reordered in place, an assigned one goes back to the queue
     void reassignDelivery(const std::string& deliveryId, const Delivery& updatedDelivery);
     
     // Mark delivery as completed
     void completeDelivery(const std::string& deliveryId);
     
-    // Get assignment details
-    DeliveryAssignment* getAssignment(const std::string& deliveryId);
+    // Copy of the assignment details; false if the delivery is not assigned
+    bool getAssignment(std::string_view deliveryId, DeliveryAssignment& assignment) const;
     
     // Get all deliveries for a vehicle
-    std::vector<std::string> getVehicleDeliveries(int vehicleId);
+    std::vector<std::string> getVehicleDeliveries(int vehicleId) const;
+    
+    // Route cache counters (hits, misses, evictions, invalidations)
+    const RouteCacheStats& getRouteCacheStats() const;
     
     // Get pending deliveries count
     int getPendingCount() const;
     
+    // Check if a delivery is still waiting in the queue
+    bool isPending(std::string_view deliveryId) const;
+    
     // Display all pending deliveries
     void displayPendingDeliveries() const;
 };
@@ -0,0 +1,57 @@
+/* =====================================================================
+Dynamic Shortest Paths (incremental SSSP maintenance)
+- Keeps shortest-path trees rooted at depots and hubs
+- After a batch of weight updates only the affected part is repaired
+  (Ramalingam-Reps style):
+    - Increase on a tree edge: the subtree below it is invalidated,
+      re-seeded from unaffected in-neighbors, then settled by Dijkstra
+    - Decrease anywhere: improved heads are pushed and propagated
+===================================================================== */
+
+#ifndef DYNAMICSHORTESTPATHS_HPP
+#define DYNAMICSHORTESTPATHS_HPP
+
+#include "Network.hpp"
+#include <vector>
+#include <cstdint>
+
+class DynamicShortestPaths {
+private:
+    // Shortest-path tree over dense indices
+    struct Tree {
+        int root;
+        std::vector<double> dist;        // max() when unreachable
+        std::vector<int> parentEdge;     // CSR slot of the tree edge into v, -1 if none
+    };
+
+    RoadNetwork* network;
+    uint64_t layoutVersion;
+    std::vector<Tree> trees;
+    int lastRepairedNodes;
+
+    // Full Dijkstra from the root
+    void rebuild(Tree& tree);
+
+    // Incremental update for a set of changed edge slots; returns nodes settled
+    int repair(Tree& tree, const std::vector<int>& changed);
+
+    const Tree* findTree(int rootId) const;
+
+public:
+    explicit DynamicShortestPaths(RoadNetwork* network);
+
+    // Maintain a tree rooted at this location (no-op if already tracked)
+    void addRoot(int locationId);
+    int rootCount() const;
+
+    // Consume the network's weight change log and repair every tree;
+    // falls back to full rebuilds if the CSR layout was re-finalized
+    void refresh();
+    int getLastRepairedNodes() const;
+
+    // Fresh distance / path from a maintained root (location IDs)
+    double distance(int rootId, int locationId) const;
+    std::vector<int> path(int rootId, int locationId) const;
+};
+
+#endif // DYNAMICSHORTESTPATHS_HPP
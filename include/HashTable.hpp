@@ -4,6 +4,13 @@ o Location Database: Hash table mapping location IDs to coordinates and details
 o Vehicle Registry: Quick vehicle lookup by ID 
 o Package Tracking: Track packages by tracking number 
 o Customer Database: Store and retrieve customer information
+Collision policies (third template parameter):
+o SeparateChaining: intrusive bucket chains (default)
+o IncrementalChaining: bucket chains, rehash spread over later operations
+o OpenAddressing: Robin Hood probing over flat arrays, power-of-two
+  capacity, backward-shift deletion (no tombstones)
+Lookups take any key type the stored key compares with, so string tables
+can be queried with std::string_view or const char* without allocating.
 ======================================================================= */
 
 #ifndef HASHTABLE_HPP
@@ -11,125 +18,291 @@ o Customer Database: Store and retrieve customer information
 
 #include "Utils.hpp"
 #include <vector>
-#include <list>
+#include <cstdlib>
+#include <new>
 #include <utility>
 #include <cmath>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <iostream>
 #include <iomanip>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+
+// ==================== Collision Policies ====================
+struct SeparateChaining {};
+struct IncrementalChaining {};   // chaining with progressive (Redis-style) rehash
+struct OpenAddressing {};
+
+// Hash used by both policies. String keys hash through string_view, which the
+// standard guarantees to match std::hash<std::string>, so a heterogeneous
+// lookup lands in the same bucket as the stored key.
+template<typename K>
+struct TableHash {
+    size_t operator()(const K& key) const { return std::hash<K>()(key); }
+};
+template<>
+struct TableHash<std::string> {
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+};
 
 // ==================== Hash Table Template ====================
+// Separate chaining over intrusive singly-linked nodes. Bucket heads are
+// plain pointers in one zero-filled block, so a bucket array of any size
+// is allocated without constructing anything. With IncrementalChaining a
+// resize only allocates the larger array; entries move over a few buckets
+// per insert/remove while lookups check both arrays, so no single
+// operation pays for a rehash.
 
-template<typename K, typename V>
+template<typename K, typename V, typename Policy = SeparateChaining>
 class HashTable {
 private:
-    std::vector<std::list<std::pair<K, V>>> table;
+    struct Entry {
+        std::pair<K, V> pair;
+        Entry* next;
+    };
+    
+    // Bucket heads from calloc: large blocks arrive as fresh zeroed pages,
+    // so neither allocating nor releasing an array walks its buckets
+    class BucketArray {
+    private:
+        Entry** heads;
+        size_t count;
+    public:
+        BucketArray() : heads(nullptr), count(0) {}
+        explicit BucketArray(size_t n)
+            : heads(static_cast<Entry**>(std::calloc(n, sizeof(Entry*)))), count(n) {
+            if (!heads) throw std::bad_alloc();
+        }
+        ~BucketArray() { std::free(heads); }
+        BucketArray(const BucketArray&) = delete;
+        BucketArray& operator=(const BucketArray&) = delete;
+        void swap(BucketArray& other) {
+            std::swap(heads, other.heads);
+            std::swap(count, other.count);
+        }
+        Entry*& operator[](size_t i) { return heads[i]; }
+        Entry* operator[](size_t i) const { return heads[i]; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+    };
+    
+    BucketArray table;
     int tableSize;
     int loadCount;
     static const int DEFAULT_SIZE = 101;
     static const float LOAD_FACTOR;
+    
+    // Previous bucket array while a progressive rehash is running
+    BucketArray draining;
+    size_t rehashIndex;                  // next draining bucket to migrate
+    static const bool INCREMENTAL = std::is_same<Policy, IncrementalChaining>::value;
+    static const int MIGRATE_STEP = 4;   // buckets migrated per insert/remove
 
     // Helper to check if resize is needed
     bool needsResize() const {
         return (float)loadCount / tableSize > LOAD_FACTOR;
     }
     
+    // Relink a bucket's nodes into the current array, no entry is copied
+    void moveBucket(Entry*& head) {
+        while (head) {
+            Entry* entry = head;
+            head = entry->next;
+            Entry*& target = table[hash(entry->pair.first)];
+            entry->next = target;
+            target = entry;
+        }
+    }
+    
+    // Migrate a bounded number of buckets from the previous array
+    void migrateStep(size_t budget = MIGRATE_STEP) {
+        if (draining.empty()) return;
+        while (budget-- > 0 && rehashIndex < draining.size()) {
+            moveBucket(draining[rehashIndex++]);
+        }
+        if (rehashIndex == draining.size()) {
+            BucketArray().swap(draining);
+            rehashIndex = 0;
+        }
+    }
+    
     // Resize hash table when load factor exceeds threshold
     void resize() {
-        int newSize = tableSize * 2;
-        std::vector<std::list<std::pair<K, V>>> oldTable = table;
+        // A migration still running is finished first (only after a burst
+        // of inserts outpacing the per-operation steps)
+        migrateStep(draining.size());
         
-        table.clear();
-        table.resize(newSize);
+        int newSize = tableSize * 2;
+        BucketArray oldTable(newSize);
+        oldTable.swap(table);
         tableSize = newSize;
-        loadCount = 0;
         
-        for (const auto& bucket : oldTable) {
-            for (const auto& pair : bucket) {
-                insert(pair.first, pair.second);
-            }
+        if (INCREMENTAL) {
+            draining.swap(oldTable);
+            rehashIndex = 0;
+            return;
+        }
+        for (size_t b = 0; b < oldTable.size(); b++) {
+            moveBucket(oldTable[b]);
         }
     }
     
     // Generic hash function
-    int hash(const K& key) const {
-        return std::hash<K>()(key) % tableSize;
+    template<typename Q>
+    int hash(const Q& key) const {
+        return TableHash<K>()(key) % tableSize;
+    }
+    
+    // Stored entry for a key in either array (nullptr if absent)
+    template<typename Q>
+    std::pair<K, V>* locate(const Q& key) {
+        for (Entry* entry = table[hash(key)]; entry; entry = entry->next) {
+            if (entry->pair.first == key) return &entry->pair;
+        }
+        if (!draining.empty()) {
+            for (Entry* entry = draining[TableHash<K>()(key) % draining.size()]; entry; entry = entry->next) {
+                if (entry->pair.first == key) return &entry->pair;
+            }
+        }
+        return nullptr;
+    }
+    template<typename Q>
+    const std::pair<K, V>* locate(const Q& key) const {
+        return const_cast<HashTable*>(this)->locate(key);
+    }
+    
+    template<typename Q>
+    bool eraseFrom(Entry*& head, const Q& key) {
+        for (Entry** link = &head; *link; link = &(*link)->next) {
+            if ((*link)->pair.first == key) {
+                Entry* entry = *link;
+                *link = entry->next;
+                delete entry;
+                loadCount--;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Delete every node of an array (the heads are left dangling)
+    static void deleteEntries(BucketArray& buckets) {
+        for (size_t b = 0; b < buckets.size(); b++) {
+            for (Entry* entry = buckets[b]; entry;) {
+                Entry* next = entry->next;
+                delete entry;
+                entry = next;
+            }
+        }
+    }
+    
+    template<typename F>
+    void forEachEntry(F visit) const {
+        for (const BucketArray* buckets : {&table, &draining}) {
+            for (size_t b = 0; b < buckets->size(); b++) {
+                for (const Entry* entry = (*buckets)[b]; entry; entry = entry->next) visit(entry->pair);
+            }
+        }
     }
 
 public:
     // Constructor
     HashTable(int size = DEFAULT_SIZE) 
-        : tableSize(size), loadCount(0) {
-        table.resize(tableSize);
-    }
+        : table(size), tableSize(size), loadCount(0), rehashIndex(0) {}
     
     // Destructor
-    ~HashTable() = default;
+    ~HashTable() {
+        deleteEntries(table);
+        deleteEntries(draining);
+    }
+    
+    // Nodes are owned by the table
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
     
     // Insert a key-value pair
     void insert(const K& key, const V& value) {
-        if (needsResize()) {
-            resize();
-        }
-        
-        int index = hash(key);
+        migrateStep();
         
         // Check if key already exists
-        for (auto& pair : table[index]) {
-            if (pair.first == key) {
-                pair.second = value;  // Update existing value
-                return;
-            }
+        if (std::pair<K, V>* existing = locate(key)) {
+            existing->second = value;  // Update existing value
+            return;
+        }
+        
+        if (needsResize()) {
+            resize();
         }
         
         // Insert new key-value pair
-        table[index].push_back({key, value});
+        Entry*& head = table[hash(key)];
+        head = new Entry{{key, value}, head};
         loadCount++;
     }
     
     // Search for a value by key
-    bool find(const K& key, V& value) const {
-        int index = hash(key);
-        
-        for (const auto& pair : table[index]) {
-            if (pair.first == key) {
-                value = pair.second;
-                return true;
-            }
+    template<typename Q>
+    bool find(const Q& key, V& value) const {
+        const std::pair<K, V>* pair = locate(key);
+        if (!pair) return false;
+        value = pair->second;
+        return true;
+    }
+    
+    // Pointer to the stored value (nullptr if absent), valid until the
+    // value's own removal: nodes are relinked, never copied
+    template<typename Q>
+    V* findPtr(const Q& key) {
+        std::pair<K, V>* pair = locate(key);
+        return pair ? &pair->second : nullptr;
+    }
+    template<typename Q>
+    const V* findPtr(const Q& key) const {
+        const std::pair<K, V>* pair = locate(key);
+        return pair ? &pair->second : nullptr;
+    }
+    
+    // Construct the value in place unless the key exists; returns the stored
+    // value and whether it was inserted (args are untouched if not)
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        migrateStep();
+        if (V* existing = findPtr(key)) return {existing, false};
+        if (needsResize()) {
+            resize();
         }
-        
-        return false;
+        Entry*& head = table[hash(key)];
+        head = new Entry{std::pair<K, V>(std::piecewise_construct, std::forward_as_tuple(key),
+                                         std::forward_as_tuple(std::forward<Args>(args)...)),
+                         head};
+        loadCount++;
+        return {&head->pair.second, true};
+    }
+    
+    // Insert or overwrite, moving the value into the table
+    std::pair<V*, bool> insert_or_assign(const K& key, V&& value) {
+        auto result = try_emplace(key, std::move(value));
+        if (!result.second) *result.first = std::move(value);
+        return result;
     }
     
     // Delete a key-value pair
-    bool remove(const K& key) {
-        int index = hash(key);
-        
-        auto it = table[index].begin();
-        while (it != table[index].end()) {
-            if (it->first == key) {
-                table[index].erase(it);
-                loadCount--;
-                return true;
-            }
-            ++it;
-        }
-        
-        return false;
+    template<typename Q>
+    bool remove(const Q& key) {
+        migrateStep();
+        if (eraseFrom(table[hash(key)], key)) return true;
+        return !draining.empty() && eraseFrom(draining[TableHash<K>()(key) % draining.size()], key);
     }
     
     // Check if a key exists
-    bool contains(const K& key) const {
-        int index = hash(key);
-        
-        for (const auto& pair : table[index]) {
-            if (pair.first == key) {
-                return true;
-            }
-        }
-        
-        return false;
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return locate(key) != nullptr;
     }
     
     // Get the current size
@@ -144,46 +317,338 @@ public:
     
     // Clear all entries
     void clear() {
-        for (auto& bucket : table) {
-            bucket.clear();
-        }
+        deleteEntries(table);
+        deleteEntries(draining);
+        BucketArray(tableSize).swap(table);
+        BucketArray().swap(draining);
+        rehashIndex = 0;
         loadCount = 0;
     }
     
     // Get all keys
     std::vector<K> getAllKeys() const {
         std::vector<K> keys;
-        for (const auto& bucket : table) {
-            for (const auto& pair : bucket) {
-                keys.push_back(pair.first);
-            }
-        }
+        forEachEntry([&keys](const std::pair<K, V>& pair) { keys.push_back(pair.first); });
         return keys;
     }
     
     // Get all values
     std::vector<V> getAllValues() const {
         std::vector<V> values;
-        for (const auto& bucket : table) {
-            for (const auto& pair : bucket) {
-                values.push_back(pair.second);
-            }
-        }
+        forEachEntry([&values](const std::pair<K, V>& pair) { values.push_back(pair.second); });
         return values;
     }
     
+    // True while entries are still being moved to the larger array
+    bool isRehashing() const {
+        return !draining.empty();
+    }
+    
     // Get statistics
     void printStatistics() const {
         std::cout << "Hash Table Statistics:\n";
         std::cout << "  Table Size: " << tableSize << "\n";
         std::cout << "  Load Count: " << loadCount << "\n";
         std::cout << "  Load Factor: " << (float)loadCount / tableSize << "\n";
+        if (isRehashing()) {
+            std::cout << "  Rehash Progress: " << rehashIndex << "/" << draining.size()
+                      << " buckets (" << std::fixed << std::setprecision(1)
+                      << 100.0 * rehashIndex / draining.size() << "%)"
+                      << std::defaultfloat << "\n";
+        }
     }
 };
 
 // Define static constant
+template<typename K, typename V, typename Policy>
+const float HashTable<K, V, Policy>::LOAD_FACTOR = 0.75f;
+
+// ==================== Open Addressing (Robin Hood) ====================
+// Entries live in one flat array; each slot's probe byte holds its distance
+// from the home bucket plus one (0 = empty), next to the entry so a probe
+// step touches one cache line. Inserts displace entries that are
+// closer to home than the incoming one, which keeps probe lengths short and
+// lets lookups stop early. Removal shifts the following run back by one.
+
+template<typename K, typename V>
+class HashTable<K, V, OpenAddressing> {
+private:
+    struct Slot {
+        uint8_t probe = 0;
+        std::pair<K, V> entry;
+    };
+    std::vector<Slot> slots;
+    size_t capacity;            // power of two
+    int shift;                  // 64 - log2(capacity)
+    int loadCount;
+    static const int DEFAULT_SIZE = 128;
+    static const uint8_t MAX_PROBE = 255;
+    static const float LOAD_FACTOR;
+    static const size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    // std::hash is the identity for integers, so take the top bits of a
+    // Fibonacci multiply (mixes every input bit into the bucket index)
+    template<typename Q>
+    size_t home(const Q& key) const {
+        uint64_t h = static_cast<uint64_t>(TableHash<K>()(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h >> shift);
+    }
+
+    template<typename Q>
+    size_t indexOf(const Q& key) const {
+        size_t pos = home(key);
+        // An entry further than its own distance from home would have
+        // displaced anything here, so the scan ends at a shorter probe
+        for (unsigned dist = 1; slots[pos].probe >= dist; dist++) {
+            if (slots[pos].probe == dist && slots[pos].entry.first == key) return pos;
+            pos = (pos + 1) & (capacity - 1);
+        }
+        return NOT_FOUND;
+    }
+
+    // Place an entry known to be absent
+    void place(std::pair<K, V> entry) {
+        size_t pos = home(entry.first);
+        unsigned dist = 1;
+        while (true) {
+            Slot& slot = slots[pos];
+            if (slot.probe == 0) {
+                slot.entry = std::move(entry);
+                slot.probe = static_cast<uint8_t>(dist);
+                loadCount++;
+                return;
+            }
+            // Take from the rich: the resident is closer to home than we are
+            if (slot.probe < dist) {
+                std::swap(entry, slot.entry);
+                unsigned resident = slot.probe;
+                slot.probe = static_cast<uint8_t>(dist);
+                dist = resident;
+            }
+            pos = (pos + 1) & (capacity - 1);
+            if (++dist == MAX_PROBE) {
+                // Pathological cluster: grow and place the entry in hand
+                resize(capacity * 2);
+                place(std::move(entry));
+                return;
+            }
+        }
+    }
+
+    void resize(size_t newCapacity) {
+        std::vector<Slot> oldSlots(newCapacity);
+        oldSlots.swap(slots);
+        capacity = newCapacity;
+        shift = shiftFor(capacity);
+        loadCount = 0;
+        for (auto& slot : oldSlots) {
+            if (slot.probe != 0) place(std::move(slot.entry));
+        }
+    }
+
+    static size_t roundUp(int size) {
+        size_t n = 8;
+        while (n < static_cast<size_t>(size)) n <<= 1;
+        return n;
+    }
+
+    static int shiftFor(size_t n) {
+        int bits = 0;
+        while ((static_cast<size_t>(1) << bits) < n) bits++;
+        return 64 - bits;
+    }
+
+public:
+    // Constructor
+    HashTable(int size = DEFAULT_SIZE)
+        : slots(roundUp(size)), capacity(roundUp(size)), shift(shiftFor(roundUp(size))), loadCount(0) {}
+
+    // Destructor
+    ~HashTable() = default;
+
+    // Insert a key-value pair
+    void insert(const K& key, const V& value) {
+        size_t pos = indexOf(key);
+        if (pos != NOT_FOUND) {
+            slots[pos].entry.second = value;  // Update existing value
+            return;
+        }
+        if (loadCount + 1 > LOAD_FACTOR * capacity) {
+            resize(capacity * 2);
+        }
+        place(std::pair<K, V>(key, value));
+    }
+
+    // Search for a value by key
+    template<typename Q>
+    bool find(const Q& key, V& value) const {
+        size_t pos = indexOf(key);
+        if (pos == NOT_FOUND) return false;
+        value = slots[pos].entry.second;
+        return true;
+    }
+
+    // Pointer to the stored value (nullptr if absent), valid until the next
+    // insertion or removal (both may move entries)
+    template<typename Q>
+    V* findPtr(const Q& key) {
+        size_t pos = indexOf(key);
+        return pos == NOT_FOUND ? nullptr : &slots[pos].entry.second;
+    }
+    template<typename Q>
+    const V* findPtr(const Q& key) const {
+        size_t pos = indexOf(key);
+        return pos == NOT_FOUND ? nullptr : &slots[pos].entry.second;
+    }
+
+    // Construct the value in place unless the key exists; returns the stored
+    // value and whether it was inserted (args are untouched if not)
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        if (V* existing = findPtr(key)) return {existing, false};
+        if (loadCount + 1 > LOAD_FACTOR * capacity) {
+            resize(capacity * 2);
+        }
+        place(std::pair<K, V>(std::piecewise_construct, std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<Args>(args)...)));
+        // A long cluster can force a grow mid-placement, so look it up again
+        return {findPtr(key), true};
+    }
+
+    // Insert or overwrite, moving the value into the table
+    std::pair<V*, bool> insert_or_assign(const K& key, V&& value) {
+        auto result = try_emplace(key, std::move(value));
+        if (!result.second) *result.first = std::move(value);
+        return result;
+    }
+
+    // Delete a key-value pair
+    template<typename Q>
+    bool remove(const Q& key) {
+        size_t pos = indexOf(key);
+        if (pos == NOT_FOUND) return false;
+
+        // Backward shift: pull the rest of the run one slot towards home
+        size_t next = (pos + 1) & (capacity - 1);
+        while (slots[next].probe > 1) {
+            slots[pos].entry = std::move(slots[next].entry);
+            slots[pos].probe = slots[next].probe - 1;
+            pos = next;
+            next = (next + 1) & (capacity - 1);
+        }
+        slots[pos].entry = std::pair<K, V>();
+        slots[pos].probe = 0;
+        loadCount--;
+        return true;
+    }
+
+    // Check if a key exists
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return indexOf(key) != NOT_FOUND;
+    }
+
+    // Get the current size
+    int size() const {
+        return loadCount;
+    }
+
+    // Check if hash table is empty
+    bool isEmpty() const {
+        return loadCount == 0;
+    }
+
+    // Clear all entries
+    void clear() {
+        for (auto& slot : slots) {
+            if (slot.probe != 0) slot = Slot();
+        }
+        loadCount = 0;
+    }
+
+    // Get all keys
+    std::vector<K> getAllKeys() const {
+        std::vector<K> keys;
+        for (const auto& slot : slots) {
+            if (slot.probe != 0) keys.push_back(slot.entry.first);
+        }
+        return keys;
+    }
+
+    // Get all values
+    std::vector<V> getAllValues() const {
+        std::vector<V> values;
+        for (const auto& slot : slots) {
+            if (slot.probe != 0) values.push_back(slot.entry.second);
+        }
+        return values;
+    }
+
+    // Snapshot support: slot count, and fn(slot, key) for every occupied slot
+    size_t slotCount() const {
+        return capacity;
+    }
+
+    template<typename F>
+    void forEachSlot(F&& fn) const {
+        for (size_t i = 0; i < capacity; i++) {
+            if (slots[i].probe != 0) fn(i, slots[i].entry.first);
+        }
+    }
+
+    // Refill from a saved layout: records[slot] is the record stored there
+    // (-1 if empty) and entryAt(record) builds its key-value pair. Entries go
+    // straight into their slots, no probing or growth; false (table left
+    // empty) unless every key is found again at its slot
+    template<typename F>
+    bool restoreSlots(const int32_t* records, size_t count, size_t recordCount, F&& entryAt) {
+        if (count < 8 || (count & (count - 1)) != 0) return false;
+        std::vector<Slot> restored(count);
+        slots.swap(restored);
+        capacity = count;
+        shift = shiftFor(count);
+        loadCount = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (records[i] == -1) continue;
+            if (records[i] < 0 || static_cast<size_t>(records[i]) >= recordCount) break;
+            slots[i].entry = entryAt(records[i]);
+            size_t dist = ((i - home(slots[i].entry.first)) & (capacity - 1)) + 1;
+            if (dist >= MAX_PROBE) break;
+            slots[i].probe = static_cast<uint8_t>(dist);
+            loadCount++;
+        }
+        bool valid = true;
+        for (size_t i = 0; i < count && valid; i++) {
+            if (records[i] == -1) continue;
+            valid = slots[i].probe != 0 && indexOf(slots[i].entry.first) == i;
+        }
+        if (!valid) {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Get statistics
+    void printStatistics() const {
+        unsigned longest = 0;
+        double total = 0.0;
+        for (const auto& slot : slots) {
+            if (slot.probe == 0) continue;
+            longest = std::max<unsigned>(longest, slot.probe);
+            total += slot.probe;
+        }
+        std::cout << "Hash Table Statistics:\n";
+        std::cout << "  Table Size: " << capacity << "\n";
+        std::cout << "  Load Count: " << loadCount << "\n";
+        std::cout << "  Load Factor: " << (float)loadCount / capacity << "\n";
+        std::cout << "  Avg Probe Length: " << (loadCount ? total / loadCount : 0.0) << "\n";
+        std::cout << "  Max Probe Length: " << longest << "\n";
+    }
+};
+
 template<typename K, typename V>
-const float HashTable<K, V>::LOAD_FACTOR = 0.75f;
+const float HashTable<K, V, OpenAddressing>::LOAD_FACTOR = 0.8f;
 
 
 #endif // HASHTABLE_HPP
\ No newline at end of file
@@ -5,6 +5,10 @@ for network analysis and pathfinding
     - Edges: Roads with weights (distance, traffic congestion, time) 
 - Graph algorithms: 
     - Dijkstra's Algorithm: Find shortest path between locations 
+    - A* Search: Goal-directed Dijkstra using a great-circle lower bound 
+    - Bidirectional Dijkstra: Meet-in-the-middle search over the reverse graph 
+    - Time-dependent Dijkstra/A*: Route for a departure time over daily
+      piecewise-linear travel-time profiles 
     - BFS/DFS: Explore connectivity and reachability 
     - Kruskal's/Prim's Algorithm: Build minimum spanning tree for infrastructure planning 
     - Bellman-Ford: Handle negative weights (e.g., toll discounts) 
@@ -19,29 +23,336 @@ for network analysis and pathfinding
 #include <queue>
 #include <stack>
 #include <unordered_set>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+// Point-to-point search strategy
+enum class SearchMode {
+    Dijkstra,       // uniform-cost search
+    AStar,          // goal-directed with a great-circle lower bound
+    Bidirectional   // forward + backward Dijkstra meeting in the middle
+};
+
+// Per-query counters for comparing search strategies
+struct SearchStats {
+    int settledNodes = 0;
+};
+
+// Dense many-to-many result in row-major order: entry (r, c) at r * cols + c
+struct DistanceMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<double> costs;         // max() when unreachable
+    std::vector<double> travelTimes;   // minutes along the cheapest path, empty unless requested
+
+    double cost(int r, int c) const { return costs[r * cols + c]; }
+    double travelTime(int r, int c) const { return travelTimes[r * cols + c]; }
+    bool reachable(int r, int c) const {
+        return costs[r * cols + c] != std::numeric_limits<double>::max();
+    }
+};
+
+// Scratch arrays for one search at a time. Between queries every entry is
+// back at its idle value, so a reused workspace costs O(touched) per query.
+struct SearchWorkspace {
+    std::vector<double> distF, distB;
+    std::vector<int> parentF, parentB;
+    std::vector<bool> settledF, settledB;
+    std::vector<int> touched;                  // nodes labelled by either side
+
+    // Size for an n-node graph (no-op when already large enough)
+    void prepare(int n);
+    // Restore idle values on the touched nodes only
+    void reset();
+};
+
+// Original per-road metrics from the city map
+struct EdgeMetrics {
+    double distance;     // km
+    double congestion;   // congestion level
+    double time;         // travel time, minutes
+};
+
+// Search cost as a non-negative linear combination of the edge metrics.
+// The balanced profile uses the live weight instead (traffic updates applied).
+// Switching profiles needs no preprocessing: costs are combined on the fly.
+struct WeightProfile {
+    int id;                    // route cache key, -1 for ad-hoc custom profiles
+    bool live;                 // use the live weight, ignore the factors
+    double distanceFactor;
+    double congestionFactor;
+    double timeFactor;
+
+    static WeightProfile balanced()       { return {0, true, 0.0, 0.0, 0.0}; }
+    static WeightProfile fastest()        { return {1, false, 0.0, 0.0, 1.0}; }
+    static WeightProfile shortest()       { return {2, false, 1.0, 0.0, 0.0}; }
+    static WeightProfile leastCongested() { return {3, false, 0.0, 1.0, 0.0}; }
+    static WeightProfile custom(double distance, double congestion, double time) {
+        // Negative factors would break Dijkstra and the A* bound
+        return {-1, false, std::max(0.0, distance), std::max(0.0, congestion), std::max(0.0, time)};
+    }
+};
+
+// New live weight for a road, addressed by its road ID
+struct RoadWeightUpdate {
+    int roadId;
+    double weight;
+};
+
+// Breakpoint of a daily piecewise-linear weight profile
+struct ProfilePoint {
+    int secondOfDay;   // 0 .. 86399
+    double weight;     // edge weight when entering the road at that time
+};
+
+class ContractionHierarchy;
+class ThreadPool;
+class SnapshotWriter;
+class SnapshotReader;
 
 class RoadNetwork{
 private: 
-    std::unordered_map<int, std::vector<std::pair<int, double>>> adjList; // <neighbor, weight>
-    std::unordered_map<int, Location> nodes;
+    // Dense location index shared with the rest of the system
+    LocationIndex index;
+
+    // Build-time staging area, only touched by the mutating operations
+    std::vector<std::vector<std::pair<int, double>>> adjList; // [index] -> <neighbor index, weight>
+    std::vector<std::vector<EdgeMetrics>> adjMetrics;         // parallel to adjList
+    std::vector<std::vector<int>> adjRoads;                    // parallel to adjList: road ID, 0 if none
+    std::vector<Location> nodes;                               // [index] -> location
+    bool hasCoordinates;                                       // every node has a position
+
+    // A* lower bound: weight >= heuristicScale * great-circle km on every edge
+    double heuristicScale;
+    EdgeMetrics metricScale;                  // same bound for each metric on its own
+    double longestEdgeKm;                     // weights above scale * this never tighten it
+
+    // Bumped by every topology or weight change; lets caches detect staleness
+    uint64_t version;
+
+    // Frozen compressed-sparse-row (CSR) layout used by every traversal
+    bool finalized;
+    std::vector<int> offsets;                 // out-edges of u: [offsets[u], offsets[u + 1])
+    std::vector<int> targets;                 // dense index of each edge's head
+    std::vector<double> weights;              // live weight of each edge
+
+    // Per-edge metrics, one array each (struct of arrays) so a profile only
+    // streams the metrics it actually uses
+    std::vector<double> distances;
+    std::vector<double> congestions;
+    std::vector<double> times;
+
+    // Reverse CSR (incoming edges) for backward searches
+    std::vector<int> reverseOffsets;          // in-edges of v: [reverseOffsets[v], reverseOffsets[v + 1])
+    std::vector<int> reverseSources;          // dense index of each in-edge's tail
+    std::vector<int> reverseEdges;            // forward edge slot, so weights stay shared
+
+    // Road ID -> edge slot (-1 if no edge carries it), re-laid by finalize()
+    std::vector<int> roadSlots;
+
+    // Edge slots whose weight changed since the last takeChangedEdges()
+    uint64_t layoutVersion;                   // bumped by finalize(): slots renumbered
+    std::vector<int> changedEdges;
+    std::vector<bool> edgeChanged;
+
+    // Time-dependent weights, staged per road ID so they survive re-layouts
+    // (and parallel roads keep their own), frozen per edge slot alongside the CSR arrays
+    std::unordered_map<int, std::vector<ProfilePoint>> stagedProfiles;
+    std::vector<int> profileOffsets;          // breakpoints of edge e: [profileOffsets[e], profileOffsets[e + 1])
+    std::vector<int> profileTimes;            // second of day, ascending within an edge
+    std::vector<double> profileWeights;       // weight at each breakpoint
+    int profiledEdges;
+    double profileHeuristicScale;             // heuristicScale that also holds under every profile
+
+    // A snapshot restore fills only the frozen arrays; the staging area is
+    // rebuilt from them on the first mutating call
+    bool stagingPending;
+    // Road-ID updates write only the frozen weights; the staged ones catch up
+    // on the next mutating call
+    bool stagedWeightsStale;
+    void restoreStaging();
+
+    // Write a live weight into edge slot e (tail u) and log the change
+    void applyEdgeWeight(int u, int e, double newWeight);
+
+    // Lay the staged profiles out against the current edge slots
+    void layoutProfiles();
+
+    // Recompute heuristicScale (and profileHeuristicScale) from the frozen edges
+    void calibrateHeuristic();
+
+    // Admissible estimate of the remaining cost from u to target: scale times
+    // the great-circle km (scale 0 gives plain Dijkstra)
+    double lowerBound(int u, int target, double scale) const;
+    // Per-km factor of that estimate under a profile (0 disables A*)
+    double profileScale(const WeightProfile& profile) const;
+
+    // Cost of edge slot e under a profile
+    double edgeCost(int e, const WeightProfile& profile) const {
+        if (profile.live) return weights[e];
+        return profile.distanceFactor * distances[e] + profile.congestionFactor * congestions[e] +
+               profile.timeFactor * times[e];
+    }
+
+    // Dijkstra / A* over dense indices using caller-owned scratch state
+    std::vector<int> search(int src, int dest, SearchMode mode, const WeightProfile& profile,
+                            SearchWorkspace& workspace, SearchStats* stats) const;
+
+    // Forward and backward Dijkstra with meet-in-the-middle termination
+    std::vector<int> bidirectionalSearch(int src, int dest, const WeightProfile& profile,
+                                         SearchWorkspace& workspace, SearchStats* stats) const;
+
+    // Dijkstra / A* over arrival times (seconds); relies on FIFO profiles
+    // (setTravelTimeProfile enforces it),
+    // i.e. entering a road later never means leaving it earlier
+    std::vector<int> timeDependentSearch(int src, int dest, double departureSeconds, bool goalDirected,
+                                         SearchWorkspace& workspace, SearchStats* stats,
+                                         double* arrivalSeconds) const;
 
 public:
+    static const int SECONDS_PER_DAY = 86400;
+
+    RoadNetwork();
+
+    // Adopt the system-wide ID -> index mapping (call before adding edges)
+    void setLocationIndex(const LocationIndex& locationIndex);
+    const LocationIndex& getLocationIndex() const;
+
     // Helper Function to get Location ID by Name
-    int getLocationIdByName(const std::string& name, const std::vector<Location>& locations);
+    int getLocationIdByName(const std::string& name, const std::vector<Location>& locations) const;
 
-    // Basic Graph Operations
+    // Basic Graph Operations (location IDs); without metrics every metric
+    // equals the weight. Structural edits are bulk operations: they unfreeze
+    // the graph, and queries / road-ID updates wait for the next finalize()
     void addEdge(int src, int dest, double weight);
+    // roadId > 0 gives the edge a stable road ID (the traffic feed's road_id)
+    void addEdge(int src, int dest, double weight, const EdgeMetrics& metrics, int roadId = 0);
     void removeEdge(int nodeId);
+    // Scans the source's edges for the destination; prefer road IDs for bursts
     void updateEdgeWeight(int src, int dest, double newWeight);
 
-    // Dijkstra's Algorithm
-    std::vector<int> shortestPath(int source, int destination);
+    // Live weight updates by road ID: one index lookup and one weight write
+    // each on the frozen graph. False / not counted for unknown road IDs,
+    // weights that are not positive and finite, or before finalize().
+    bool updateRoadWeight(int roadId, double newWeight);
+    int updateRoadWeights(const RoadWeightUpdate* updates, size_t count);
+    int updateRoadWeights(const std::vector<RoadWeightUpdate>& updates);
+
+    // Edge slot of a road ID (-1 if unknown); IDs range below roadLimit()
+    int roadSlot(int roadId) const;
+    int roadLimit() const;
+
+    // Attach coordinates to the graph nodes (enables A*)
+    void setNodes(const std::vector<Location>& locations);
+    double getHeuristicScale() const;
+
+    // Daily travel-time profile for a road (its road ID), linear between
+    // breakpoints and wrapping around midnight; an empty list removes it.
+    // Weights are minutes of travel; a drop faster than one minute per minute
+    // would let a later departure arrive earlier, so such breakpoints are
+    // raised to that slope. Only time-dependent queries read profiles. Set them before finalize()
+    // when loading many, each call on a frozen graph re-lays them.
+    void setTravelTimeProfile(int roadId, std::vector<ProfilePoint> points);
+    int profileCount() const;
+
+    // Freeze the staged adjacency into the CSR arrays (call after building the
+    // graph, and again after a batch of addEdge / removeEdge)
+    void finalize();
+    bool isFinalized() const;
+    int nodeCount() const;
+    int edgeCount() const;
+
+    // Read-only access to the frozen CSR arrays (dense indices)
+    int edgeBegin(int u) const { return offsets[u]; }
+    int edgeEnd(int u) const { return offsets[u + 1]; }
+    int edgeTarget(int e) const { return targets[e]; }
+    double edgeWeight(int e) const { return weights[e]; }
+    double edgeDistance(int e) const { return distances[e]; }
+    double edgeCongestion(int e) const { return congestions[e]; }
+    double edgeTime(int e) const { return times[e]; }
+    int edgeSource(int e) const;
+    int reverseBegin(int v) const { return reverseOffsets[v]; }
+    int reverseEnd(int v) const { return reverseOffsets[v + 1]; }
+    int reverseSource(int i) const { return reverseSources[i]; }
+    int reverseEdge(int i) const { return reverseEdges[i]; }
+
+    // Weight of edge slot e when entered at a time of day (static weight if unprofiled)
+    double edgeWeightAt(int e, double secondOfDay) const;
+
+    // Weight change log for incremental consumers (dynamic shortest paths)
+    std::vector<int> takeChangedEdges();
+    uint64_t getLayoutVersion() const;
+
+    // Hash of the frozen topology and weights, used to detect stale derived data
+    uint64_t fingerprint() const;
+
+    // Graph version counter (cheap staleness check for in-memory caches)
+    uint64_t getVersion() const;
+
+    // Binary snapshot of the frozen graph (CSR, metrics, profiles, heuristic
+    // scales). A restore takes the place of building and finalize(): set the
+    // same location index and nodes first. False if the arrays do not fit.
+    void writeSnapshot(SnapshotWriter& writer) const;
+    bool readSnapshot(const SnapshotReader& reader);
+
+    // Queries below only read the frozen arrays, so any number of threads may
+    // run them concurrently as long as no mutating call runs at the same time.
+
+    // Dijkstra / A* over dense indices; returns the index path
+    std::vector<int> shortestPathIndices(int src, int dest,
+                                         SearchMode mode = SearchMode::Dijkstra,
+                                         SearchStats* stats = nullptr,
+                                         const WeightProfile& profile = WeightProfile::balanced()) const;
+
+    // Dijkstra's Algorithm (or A* when requested) under a weight profile
+    std::vector<int> shortestPath(int source, int destination,
+                                  SearchMode mode = SearchMode::Dijkstra,
+                                  SearchStats* stats = nullptr,
+                                  const WeightProfile& profile = WeightProfile::balanced()) const;
+
+    // Total cost of an ID path under a profile (max() if not a path)
+    double pathCost(const std::vector<int>& path,
+                    const WeightProfile& profile = WeightProfile::balanced()) const;
+
+    // Time-dependent route for a departure time (seconds; only the time of day
+    // matters). Weights count as minutes of travel and are read when each road
+    // is entered. Dijkstra or A*; Bidirectional falls back to Dijkstra since
+    // the arrival time is unknown. arrivalSeconds gets the arrival time.
+    std::vector<int> shortestPathAt(int source, int destination, double departureSeconds,
+                                    SearchMode mode = SearchMode::AStar,
+                                    SearchStats* stats = nullptr,
+                                    double* arrivalSeconds = nullptr) const;
+
+    // Batch of (source, destination) location ID pairs routed across the pool,
+    // one workspace per worker. Uses the hierarchy when it matches this graph
+    // and the profile is the live one (the hierarchy is built on live weights).
+    // Result i is the path for queries[i] (empty if unreachable).
+    std::vector<std::vector<int>> shortestPaths(const std::vector<std::pair<int, int>>& queries,
+                                                ThreadPool& pool,
+                                                SearchMode mode = SearchMode::AStar,
+                                                const ContractionHierarchy* hierarchy = nullptr,
+                                                const WeightProfile& profile = WeightProfile::balanced()) const;
+
+    // Many-to-many costs between location IDs in one pass: bucket search over
+    // the hierarchy when it matches this graph, otherwise one pruned Dijkstra
+    // per source. withTravelTimes also sums the roads' travel times (minutes)
+    // along each cheapest path; that needs the per-source searches, since
+    // hierarchy shortcuts carry no per-road times.
+    DistanceMatrix distanceMatrix(const std::vector<int>& sources,
+                                  const std::vector<int>& destinations,
+                                  const ContractionHierarchy* hierarchy = nullptr,
+                                  bool withTravelTimes = false) const;
+    DistanceMatrix distanceMatrixIndices(const std::vector<int>& sources,
+                                         const std::vector<int>& destinations,
+                                         const ContractionHierarchy* hierarchy = nullptr,
+                                         bool withTravelTimes = false) const;
 
     // BFS Traversal
-    std::vector<int> bfs(Node* startNode);
+    std::vector<int> bfs(const Node* startNode) const;
 
     // DFS Traversal
-    std::vector<int> dfs(Node* startNode);
+    std::vector<int> dfs(const Node* startNode) const;
 
     
 };
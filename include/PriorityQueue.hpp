@@ -0,0 +1,338 @@
+/* =======================================================================
+Indexed priority queues (d-ary heaps) for delivery scheduling
+o Every element is queued under a unique key, so any element can be found,
+  reprioritized or removed in O(log n), not only the top
+o The comparator / sort key is a template parameter and gets inlined
+o Arity is configurable; the default 4-ary heap is shallower than a binary
+  one and scans its children from a single cache line
+Layouts:
+o PriorityQueue: the heap holds the elements themselves
+o CompactPriorityQueue: the heap holds (sort key, handle) pairs only and
+  the elements stay put in a side pool, so sifting never moves them
+======================================================================= */
+
+#ifndef PRIORITYQUEUE_HPP
+#define PRIORITYQUEUE_HPP
+
+#include "HashTable.hpp"
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+
+// ==================== Priority Queue Template ====================
+// comparator(a, b) is true when a must leave the queue before b
+template<typename Key, typename T, typename Compare = std::less<T>, int Arity = 4>
+class PriorityQueue {
+private:
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    struct Entry {
+        Key key;
+        T value;
+    };
+
+    std::vector<Entry> heap;
+    HashTable<Key, int, OpenAddressing> positions;   // key -> heap index
+    Compare comparator;
+
+    // Put an entry in a heap slot and record where it went
+    void place(int index, Entry&& entry) {
+        heap[index] = std::move(entry);
+        *positions.findPtr(heap[index].key) = index;
+    }
+
+    // Restore heap property by moving element up (shifting parents into the hole)
+    void heapifyUp(int index) {
+        Entry entry = std::move(heap[index]);
+        while (index > 0) {
+            int parent = (index - 1) / Arity;
+            if (!comparator(entry.value, heap[parent].value)) break;
+            place(index, std::move(heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(entry));
+    }
+
+    // Restore heap property by moving element down
+    void heapifyDown(int index) {
+        int size = heap.size();
+        Entry entry = std::move(heap[index]);
+        while (true) {
+            int first = index * Arity + 1;
+            if (first >= size) break;
+            int last = std::min(first + Arity, size);
+            int best = first;
+            for (int child = first + 1; child < last; child++) {
+                if (comparator(heap[child].value, heap[best].value)) best = child;
+            }
+            if (!comparator(heap[best].value, entry.value)) break;
+            place(index, std::move(heap[best]));
+            index = best;
+        }
+        place(index, std::move(entry));
+    }
+
+    // Remove the entry at a heap position and repair the heap around it
+    void removeAt(int index) {
+        positions.remove(heap[index].key);
+        int last = heap.size() - 1;
+        if (index != last) {
+            place(index, std::move(heap[last]));
+        }
+        heap.pop_back();
+        // The moved entry may belong above or below its new slot
+        if (index < (int)heap.size()) {
+            heapifyUp(index);
+            heapifyDown(index);
+        }
+    }
+
+public:
+    explicit PriorityQueue(Compare cmp = Compare())
+        : comparator(cmp) {}
+
+    // Insert element under key; an already queued key is updated instead.
+    // Returns true if the key was new.
+    bool push(const Key& key, const T& element) {
+        if (update(key, element)) return false;
+        positions.insert(key, heap.size());
+        heap.push_back({key, element});
+        heapifyUp(heap.size() - 1);
+        return true;
+    }
+
+    // Replace a queued element and move it to its new place
+    template<typename Q>
+    bool update(const Q& key, const T& element) {
+        int* position = positions.findPtr(key);
+        if (!position) return false;
+        int index = *position;
+        heap[index].value = element;
+        heapifyUp(index);
+        heapifyDown(*position);
+        return true;
+    }
+
+    // Remove a queued element by key
+    template<typename Q>
+    bool erase(const Q& key) {
+        const int* position = positions.findPtr(key);
+        if (!position) return false;
+        removeAt(*position);
+        return true;
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return positions.contains(key);
+    }
+
+    // Queued element for a key (nullptr if absent), valid until the next change
+    template<typename Q>
+    const T* find(const Q& key) const {
+        const int* position = positions.findPtr(key);
+        return position ? &heap[*position].value : nullptr;
+    }
+
+    // Remove and return the top (highest priority) element
+    T pop() {
+        if (heap.empty()) {
+            throw std::runtime_error("Priority queue is empty");
+        }
+        T top = std::move(heap[0].value);
+        removeAt(0);
+        return top;
+    }
+
+    // Return top element without removing
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::runtime_error("Priority queue is empty");
+        }
+        return heap[0].value;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    void clear() {
+        heap.clear();
+        positions.clear();
+    }
+};
+
+// ==================== Compact Priority Queue ====================
+// SortKeyOf maps an element to a small ordered key (e.g. a packed integer);
+// the smallest key leaves first. The key is taken once per push/update.
+template<typename Key, typename T, typename SortKeyOf, int Arity = 4>
+class CompactPriorityQueue {
+private:
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    typedef decltype(std::declval<SortKeyOf>()(std::declval<const T&>())) SortKey;
+
+    struct Node {
+        SortKey sortKey;
+        uint32_t handle;
+    };
+    struct Payload {
+        Key key;
+        T value;
+        int position;   // index of its node in the heap
+    };
+
+    std::vector<Node> heap;
+    std::vector<Payload> payloads;          // indexed by handle, slots are reused
+    std::vector<uint32_t> freeHandles;
+    HashTable<Key, uint32_t, OpenAddressing> handles;   // key -> handle
+    SortKeyOf sortKeyOf;
+
+    void place(int index, const Node& node) {
+        heap[index] = node;
+        payloads[node.handle].position = index;
+    }
+
+    void heapifyUp(int index) {
+        Node node = heap[index];
+        while (index > 0) {
+            int parent = (index - 1) / Arity;
+            if (!(node.sortKey < heap[parent].sortKey)) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, node);
+    }
+
+    void heapifyDown(int index) {
+        int size = heap.size();
+        Node node = heap[index];
+        while (true) {
+            int first = index * Arity + 1;
+            if (first >= size) break;
+            int last = std::min(first + Arity, size);
+            int best = first;
+            for (int child = first + 1; child < last; child++) {
+                if (heap[child].sortKey < heap[best].sortKey) best = child;
+            }
+            if (!(heap[best].sortKey < node.sortKey)) break;
+            place(index, heap[best]);
+            index = best;
+        }
+        place(index, node);
+    }
+
+    // Unlink the node at a heap position; its payload slot becomes free
+    void removeAt(int index) {
+        uint32_t handle = heap[index].handle;
+        handles.remove(payloads[handle].key);
+        freeHandles.push_back(handle);
+        int last = heap.size() - 1;
+        if (index != last) {
+            place(index, heap[last]);
+        }
+        heap.pop_back();
+        // The moved node may belong above or below its new slot
+        if (index < (int)heap.size()) {
+            heapifyUp(index);
+            heapifyDown(index);
+        }
+    }
+
+public:
+    explicit CompactPriorityQueue(SortKeyOf keyOf = SortKeyOf())
+        : sortKeyOf(keyOf) {}
+
+    // Insert element under key; an already queued key is updated instead.
+    // Returns true if the key was new.
+    bool push(const Key& key, const T& element) {
+        if (update(key, element)) return false;
+        uint32_t handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            payloads[handle].key = key;
+            payloads[handle].value = element;
+        } else {
+            handle = payloads.size();
+            payloads.push_back({key, element, 0});
+        }
+        handles.insert(key, handle);
+        heap.push_back({sortKeyOf(element), handle});
+        heapifyUp(heap.size() - 1);
+        return true;
+    }
+
+    template<typename Q>
+    bool update(const Q& key, const T& element) {
+        const uint32_t* handle = handles.findPtr(key);
+        if (!handle) return false;
+        Payload& payload = payloads[*handle];
+        payload.value = element;
+        int index = payload.position;
+        heap[index].sortKey = sortKeyOf(element);
+        heapifyUp(index);
+        heapifyDown(payload.position);
+        return true;
+    }
+
+    template<typename Q>
+    bool erase(const Q& key) {
+        const uint32_t* handle = handles.findPtr(key);
+        if (!handle) return false;
+        removeAt(payloads[*handle].position);
+        return true;
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return handles.contains(key);
+    }
+
+    // Queued element for a key (nullptr if absent); sifting never moves it,
+    // so only the next push may invalidate it
+    template<typename Q>
+    const T* find(const Q& key) const {
+        const uint32_t* handle = handles.findPtr(key);
+        return handle ? &payloads[*handle].value : nullptr;
+    }
+
+    T pop() {
+        if (heap.empty()) {
+            throw std::runtime_error("Priority queue is empty");
+        }
+        T top = std::move(payloads[heap[0].handle].value);
+        removeAt(0);
+        return top;
+    }
+
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::runtime_error("Priority queue is empty");
+        }
+        return payloads[heap[0].handle].value;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    void clear() {
+        heap.clear();
+        payloads.clear();
+        freeHandles.clear();
+        handles.clear();
+    }
+};
+
+#endif // PRIORITYQUEUE_HPP
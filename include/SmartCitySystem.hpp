@@ -3,7 +3,7 @@ Smart City Delivery & Traffic Management System
 Integrated platform for logistics and traffic coordination
 
 Components:
-- Graph algorithms (Dijkstra, BFS, DFS)
+- Graph algorithms (Dijkstra, A*, BFS, DFS, Contraction Hierarchies)
 - Hash tables for fast lookups
 - Spatial indexing (QuadTree, BST, SegmentTree)
 - Route optimization (Greedy, D&C, Sorting)
@@ -16,10 +16,16 @@ Components:
 
 #include "Utils.hpp"
 #include "Network.hpp"
+#include "ContractionHierarchy.hpp"
+#include "DynamicShortestPaths.hpp"
 #include "HashTable.hpp"
+#include "ConcurrentHashTable.hpp"
 #include "SpatialIndex.hpp"
 #include "DeliveryScheduler.hpp"
 #include "RouteOptimizer.hpp"
+#include "ThreadPool.hpp"
+#include "CitySnapshot.hpp"
+#include "TrafficStream.hpp"
 #include <vector>
 #include <iostream>
 
@@ -28,11 +34,21 @@ private:
     RoadNetwork roadNetwork;
     RouteOptimizer routeOptimizer;
     
-    // Hash tables for fast entity lookup
-    HashTable<int, Location> locationRegistry;
-    HashTable<int, Vehicle> vehicleRegistry;
-    HashTable<std::string, Delivery> deliveryRegistry;
-    HashTable<int, TrafficEvent> trafficRegistry;
+    // Preprocessed routing hierarchy, cached on disk between runs
+    ContractionHierarchy routingHierarchy;
+    
+    // Shortest-path trees from depots and hubs, repaired after traffic updates
+    DynamicShortestPaths* hubDistances;
+    
+    // Location ID -> dense index (0..N-1) and interned names, built once at load time
+    LocationIndex locationIndex;
+    
+    // Hash tables for fast entity lookup (sharded open addressing, safe to
+    // fill and query from worker threads)
+    ConcurrentHashTable<int, Location> locationRegistry;
+    ConcurrentHashTable<int, Vehicle> vehicleRegistry;
+    ConcurrentHashTable<std::string, Delivery> deliveryRegistry;
+    ConcurrentHashTable<int, TrafficEvent> trafficRegistry;
     
     // Spatial indexing
     QuadTree* spatialIndex;
@@ -41,11 +57,20 @@ private:
     // Delivery management
     DeliveryScheduler* scheduler;
     
+    // Workers for batch routing
+    ThreadPool workerPool;
+    
     // Data storage
     std::vector<Location> locations;
     std::vector<Vehicle> vehicles;
     std::vector<Delivery> deliveries;
     std::vector<TrafficEvent> trafficEvents;
+    std::vector<Edge> cityMap;
+    
+    // Binary snapshot of the loaded and built state; used at startup while
+    // the source CSVs match the stamps taken when it was written
+    bool bootedFromSnapshot;
+    std::vector<SourceStamp> sourceStamps;
     
 public:
     SmartCityDeliverySystem();
@@ -57,17 +82,27 @@ public:
     // Run the full system demonstration
     void runFullSystem();
     
+    // Apply traffic updates tailed from a file or named pipe for a number of
+    // seconds, reporting ingestion metrics once per second (call initialize() first)
+    void streamTrafficUpdates(const std::string& path, int seconds);
+    
 private:
     // Helper initialization methods
     void loadData();
+    bool loadSnapshot(const std::string& path);
+    void saveSnapshot(const std::string& path);
     void initializeSpatialIndex();
     void buildRoadNetwork();
+    void applyTrafficProfiles(const std::vector<double>& baseWeights);
+    void prepareRoutingHierarchy();
+    void initializeHubTrees();
     
     // Demonstration methods
     void runDeliveryOptimization();
     void demonstratePathfinding();
     void demonstrateSpatialQueries();
     void demonstrateClosestPairAnalysis();
+    void demonstrateTrafficStream();
     void displayAnalytics();
 };
 
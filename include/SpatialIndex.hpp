@@ -13,28 +13,46 @@ Spatial Indexing (Trees)
 #include <algorithm>
 #include "Utils.hpp"
 
+class SnapshotWriter;
+class SnapshotReader;
+
 // ==================== QUADTREE CLASS ====================
-// Partitions city space into 4 quadrants for efficient spatial queries
+// Partitions city space into 4 quadrants for efficient spatial queries.
+// Nodes live in one array addressed by 32-bit indices; leaf locations sit in
+// fixed-capacity blocks with their coordinates copied in, so queries never
+// leave the two arrays until they return a match.
 class QuadTree {
 private:
+    static const int MAX_CAPACITY = 4;
+    static const int NONE = -1;
+
     struct Node {
         double x, y, width, height;                    // quadrant bounds
-        std::vector<Location*> locations;              // locations in this node
-        Node* children[4];                             // NW, NE, SW, SE
-        Node(double cx, double cy, double w, double h) 
-            : x(cx), y(cy), width(w), height(h) { 
-            for (int i = 0; i < 4; i++) children[i] = nullptr; 
-        }
+        int firstChild;                                // NW, NE, SW, SE at firstChild..+3; NONE for a leaf
+        int block;                                     // leaf locations; NONE if empty or inner
     };
-    
-    Node* root;
-    static const int MAX_CAPACITY = 4;
-    
+
+    struct LeafEntry {
+        double longitude, latitude;                    // copied from the location
+        Location* location;
+    };
+
+    struct LeafBlock {
+        LeafEntry entries[MAX_CAPACITY];
+        int count;
+    };
+
+    std::vector<Node> nodes;                           // root at index 0
+    std::vector<LeafBlock> blocks;
+    std::vector<int> freeBlocks;                       // released by subdivided leaves
+
+    int addLeaf(double cx, double cy, double w, double h);
+    int allocateBlock();
+
     // Helper functions for recursive operations
-    void insert(Node* node, Location* loc);
-    void radiusSearch(Node* node, double cx, double cy, double r, std::vector<Location*>& result);
-    Location* findNearest(Node* node, double x, double y, double& minDist, Location* current);
-    void deleteTree(Node* node);
+    void insert(int node, const LeafEntry& entry);
+    void radiusSearch(int node, double cx, double cy, double r, std::vector<Location*>& result) const;
+    Location* findNearest(int node, double x, double y, double& minDist, Location* current) const;
     
     // Distance calculation between two geographic points
     double distance(double x1, double y1, double x2, double y2) const {
@@ -44,11 +62,15 @@ private:
     
 public:
     QuadTree(double centerX, double centerY, double width, double height);
-    ~QuadTree();
     
     void insert(Location* location);
-    std::vector<Location*> radiusSearch(double centerX, double centerY, double radius);
-    Location* findNearest(double x, double y);
+    std::vector<Location*> radiusSearch(double centerX, double centerY, double radius) const;
+    Location* findNearest(double x, double y) const;
+    
+    // Binary snapshot: the node array as is, leaf entries stored as indices
+    // into the locations vector the tree points into. A restore replaces the tree.
+    bool writeSnapshot(SnapshotWriter& writer, const std::vector<Location>& locations) const;
+    bool readSnapshot(const SnapshotReader& reader, std::vector<Location>& locations);
 };
 
 // ==================== BINARY SEARCH TREE CLASS ====================
@@ -68,7 +90,7 @@ private:
     Node* insertHelper(Node* node, const Delivery& delivery);
     Node* deleteHelper(Node* node, const std::string& id);
     Node* findMin(Node* node);
-    void collectInRange(Node* node, const std::string& start, const std::string& end, 
+    void collectInRange(Node* node, long long start, long long end, 
                        std::vector<Delivery>& result);
     void deleteTree(Node* node);
     
@@ -80,6 +102,12 @@ public:
     Delivery* getEarliestDeadline();
     std::vector<Delivery> rangeSearch(const std::string& startDeadline, const std::string& endDeadline);
     void deleteDelivery(const std::string& deliveryId);
+    
+    // Binary snapshot: the node shape as (delivery index, left, right) triples
+    // in preorder, children as triple indices (-1 if none). A restore relinks
+    // the saved shape without comparing keys down from the root.
+    bool writeSnapshot(SnapshotWriter& writer, const std::vector<Delivery>& deliveries) const;
+    bool readSnapshot(const SnapshotReader& reader, const std::vector<Delivery>& deliveries);
 };
 
 // ==================== SEGMENT TREE CLASS ====================
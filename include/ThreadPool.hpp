@@ -0,0 +1,49 @@
+/* =====================================================================
+Fixed-size worker pool for data-parallel work
+- Workers are started once and reused for every batch
+- submit(): queue a single task, returns a future for completion/errors
+- parallelFor(): spread an index range over the workers; each call of the
+  body gets a worker slot so callers can keep per-thread scratch state
+===================================================================== */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    // threadCount <= 0 uses the hardware concurrency (at least one worker)
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const;
+
+    // Queue a task; the future rethrows anything the task threw
+    std::future<void> submit(std::function<void()> task);
+
+    // Run body(slot, i) for every i in [0, count) and wait for all of them.
+    // slot is in [0, size()) and never shared by two concurrent calls.
+    // Must not be called from inside a pool task.
+    void parallelFor(size_t count, const std::function<void(int, size_t)>& body);
+};
+
+#endif // THREADPOOL_HPP
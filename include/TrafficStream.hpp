@@ -0,0 +1,131 @@
+/* =====================================================================
+Streaming traffic-update ingestion
+- A reader thread tails a file or named pipe of traffic rows in the
+  Traffic_updates.csv format (road_id,new_weight[,timestamp]); a file is
+  followed like `tail -f`, a pipe may be reopened by new writers
+- A final row without a newline is taken as complete once a file has
+  been quiet for a window, and on stop()
+- Updates are coalesced per road over a short window: within a window
+  only the last weight of each road is kept
+- Each window is applied to the road graph as one batch of road-ID
+  weight writes (RoadNetwork::updateRoadWeights) under an exclusive lock; queries hold the shared side (readLock()), so they see
+  either none or all of a batch
+- Metrics: accepted / rejected (malformed, unknown road, weight <= 0) /
+  coalesced updates, batches, lock hold time per batch, and latency from
+  receiving an update to routing on it
+===================================================================== */
+
+#ifndef TRAFFICSTREAM_HPP
+#define TRAFFICSTREAM_HPP
+
+#include "Network.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct TrafficStreamStats {
+    long long linesRead = 0;
+    long long updatesAccepted = 0;   // parsed, for a known road
+    long long rejected = 0;          // malformed rows, unknown roads, weights <= 0
+    long long coalesced = 0;         // superseded by a later update in the same window
+    long long batches = 0;
+    long long roadsApplied = 0;
+    double totalApplyMs = 0.0;       // exclusive lock held per batch
+    double maxApplyMs = 0.0;
+    double totalLatencyMs = 0.0;     // oldest update of a batch received -> batch applied
+    double maxLatencyMs = 0.0;
+    double elapsedSeconds = 0.0;     // since start()
+
+    double updatesPerSecond() const {
+        return elapsedSeconds > 0.0 ? updatesAccepted / elapsedSeconds : 0.0;
+    }
+};
+
+class TrafficStream {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    RoadNetwork& network;
+    std::vector<bool> knownRoads;                 // road ID -> present in the graph
+    std::chrono::milliseconds window;
+
+    // Guards the graph: batches write under the exclusive side
+    mutable std::shared_mutex graphLock;
+
+    // Input: a descriptor where poll() exists, else a stream read in a loop
+#ifndef _WIN32
+    int descriptor;
+#else
+    std::ifstream input;
+    std::string inputPath;
+#endif
+    bool regularFile;                // a file has a size to catch up with, a pipe does not
+    std::thread reader;
+    std::atomic<bool> stopping;
+    std::atomic<bool> idle;          // at end of input with nothing pending
+    long long readOffset;            // bytes read so far (reader thread only)
+    std::atomic<long long> appliedOffset;   // every row before it has been applied
+
+    // Current window, reader thread only: latest weight per road
+    std::vector<double> pendingWeight;
+    std::vector<bool> pendingFlag;
+    std::vector<int> pendingRoads;
+    std::vector<RoadWeightUpdate> batch;
+    bool headerAllowed;              // the next row may be a CSV header
+    std::vector<std::string_view> fields;
+    std::string buffer;              // bytes after the last complete line
+    Clock::time_point lastInput;
+    Clock::time_point windowStart;
+    Clock::time_point started;
+
+    mutable std::mutex statsMutex;
+    TrafficStreamStats stats;
+
+    void run();
+    // Next bytes of input (0 at the current end)
+    long readInput(char* buffer, size_t capacity);
+    // Split complete lines off the buffer and queue their updates
+    void consume();
+    // Queue the unterminated last line, if any
+    void consumePartial();
+    // Current size of the input file (-1 for a pipe)
+    long long inputSize() const;
+    void queueUpdate(std::string_view line, TrafficStreamStats& counts);
+    // Apply the current window as one batch
+    void flush();
+
+public:
+    // Accepts updates for the road IDs the finalized graph holds now
+    explicit TrafficStream(RoadNetwork& network, int windowMs = 100);
+    ~TrafficStream();
+
+    TrafficStream(const TrafficStream&) = delete;
+    TrafficStream& operator=(const TrafficStream&) = delete;
+
+    // Start tailing a file or named pipe; fromStart = false skips what a
+    // file already holds. False if it cannot be opened or already running.
+    bool start(const std::string& path, bool fromStart = true);
+
+    // Stop the reader and apply whatever the current window holds
+    void stop();
+    bool isRunning() const;
+
+    // Wait until everything written so far has been applied; false on timeout
+    bool waitUntilIdle(int timeoutMs);
+
+    // Shared lock on the graph for queries that must not see a half-applied batch
+    std::shared_lock<std::shared_mutex> readLock() const;
+    // Exclusive lock for other writers, e.g. consumers of the change log
+    std::unique_lock<std::shared_mutex> writeLock() const;
+
+    TrafficStreamStats getStats() const;
+    void printStatistics() const;
+};
+
+#endif // TRAFFICSTREAM_HPP
@@ -7,6 +7,10 @@
 #include <string>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include <string_view>
 
 // ==================== Data Structures ==================== //
 
@@ -52,6 +56,9 @@ struct Package {
           weight(w), status(stat), currentLocationId(locID) {}
 };
 
+// Delivery urgency; a larger value is more urgent
+enum class PriorityLevel : uint8_t { Low = 1, Medium = 2, High = 3 };
+
 // Delivery structure
 struct Delivery {
     std::string id;
@@ -59,6 +66,31 @@ struct Delivery {
     double weight;
     std::string deadline;
     std::string priority;
+    
+    // Location IDs of source / destination resolved at load, -1 if unknown
+    int sourceId = -1;
+    int destinationId = -1;
+    
+    // Parsed once at load (see FileUtils::parseSchedule); the strings above
+    // are kept for display and export only
+    PriorityLevel level = PriorityLevel::Low;
+    long long deadlineEpoch = -1;   // seconds since the Unix epoch, -1 if unknown
+    
+    // Packed 64-bit sort keys, smaller goes first. Unknown deadlines sort last.
+    // deadlineKey: earlier deadline, then higher priority (optimizer, BST)
+    uint64_t deadlineKey() const {
+        return (deadlineBits() << 2) | (3 - static_cast<uint64_t>(level));
+    }
+    // urgencyKey: higher priority, then earlier deadline (scheduler)
+    uint64_t urgencyKey() const {
+        return ((3 - static_cast<uint64_t>(level)) << 62) | deadlineBits();
+    }
+    
+private:
+    uint64_t deadlineBits() const {
+        const uint64_t unknown = (uint64_t(1) << 60) - 1;
+        return deadlineEpoch < 0 ? unknown : std::min<uint64_t>(deadlineEpoch, unknown);
+    }
 };
 
 // Customer structure
@@ -80,6 +112,8 @@ struct Customer {
 struct Edge {
     std::string source, destination;
     double distance, traffic_congestion, traffic_time;
+    int sourceId = -1, destinationId = -1;   // resolved location IDs, -1 if unknown
+    int road_id = 0;                         // data row in City_map.csv (1-based), the feed's road_id
 };
 
 struct Node {
@@ -93,16 +127,81 @@ struct TrafficEvent {
     int new_weight;
 };
 
+class SnapshotWriter;
+class SnapshotReader;
+
+// ==================== Location Index ==================== //
+// Remaps arbitrary location IDs to contiguous indices 0..N-1 so internal
+// structures can be plain vectors; IDs are only used at the API boundary.
+// Location names are interned alongside, so name lookups are O(1) too.
+class LocationIndex {
+private:
+    std::vector<int> ids;                   // index -> location ID
+    std::unordered_map<int, int> indices;   // location ID -> index
+    
+    // Name dictionary: linear-probing table of indices (-1 = empty) over
+    // the interned names, power-of-two sized and at most half full
+    std::vector<std::string> names;         // index -> name ("" if unnamed)
+    std::vector<int> nameSlots;
+    
+    void internName(int index);
+    void rebuildNameSlots();
+
+public:
+    // Assign indices in file order (index i == locations[i]) and intern names
+    void build(const std::vector<Location>& locations);
+
+    // Index of a location ID, appending a new one if it is unknown
+    int add(int locationId);
+
+    int toIndex(int locationId) const;   // -1 if unknown
+    int toId(int index) const;           // -1 if out of range
+    
+    // Name -> index / location ID, -1 if unknown (first location wins on duplicates)
+    int indexOfName(std::string_view name) const;
+    int idOfName(std::string_view name) const;
+    
+    // Fill sourceId / destinationId from the endpoint names
+    void resolve(std::vector<Edge>& edges) const;
+    void resolve(std::vector<Delivery>& deliveries) const;
+    int size() const;
+    void clear();
+    
+    // Binary snapshot: IDs, names and the probe table as written, so a
+    // restore re-hashes no names
+    void writeSnapshot(SnapshotWriter& writer) const;
+    bool readSnapshot(const SnapshotReader& reader);
+};
+
+class ThreadPool;
+
 class FileUtils {
 public:
     static std::vector<std::string> parseCSVLine(const std::string& line);
     static std::vector<Edge> loadCityMap();    
     static std::vector<Location> loadLocations();
     static std::vector<Vehicle> loadVehicles();
-    static std::vector<Delivery> loadDeliveries();
-    static std::vector<TrafficEvent> loadTrafficUpdates();
+    // The large exports can be parsed in parallel chunks on a worker pool;
+    // rows keep their file order either way
+    static std::vector<Delivery> loadDeliveries(ThreadPool* pool = nullptr);
+    static std::vector<TrafficEvent> loadTrafficUpdates(ThreadPool* pool = nullptr);
+
+    // Paths of the CSV files the loaders read
+    static std::vector<std::string> dataFiles();
 
     double calculateDistance(double x1, double y1, double x2, double y2);
+
+    // Great-circle (haversine) distance in kilometres between two lat/lon points
+    static double greatCircleDistance(double lat1, double lon1, double lat2, double lon2);
+
+    // "YYYY-MM-DDTHH:MM[:SS]" (UTC) -> seconds since the Unix epoch, -1 if malformed
+    static long long parseTimestamp(std::string_view timestamp);
+
+    // "High" / "Medium" / anything else -> PriorityLevel (Low)
+    static PriorityLevel parsePriority(const std::string& priority);
+
+    // Fill a delivery's level and deadlineEpoch from its priority/deadline strings
+    static void parseSchedule(Delivery& delivery);
 };
 
 #endif // UTILS_HPP
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "Benchmarks.hpp"
+#include "Network.hpp"
+#include "HashTable.hpp"
+#include "PriorityQueue.hpp"
+#include "TrafficStream.hpp"
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+bool Benchmarks::run(const std::string& name, int size) {
+    bool all = (name == "all");
+    bool matched = false;
+
+    if (all || name == "routing") {
+        if (size > 0) {
+            routingBenchmark(size, 200);
+        } else {
+            routingBenchmark(100, 200);
+            routingBenchmark(300, 200);
+        }
+        matched = true;
+    }
+    if (all || name == "hashtable") {
+        hashTableBenchmark(size > 0 ? size : 10000000);
+        matched = true;
+    }
+    if (all || name == "rehash") {
+        rehashLatencyBenchmark(size > 0 ? size : 4000000);
+        matched = true;
+    }
+    if (all || name == "heap") {
+        priorityQueueBenchmark(size > 0 ? size : 1000000);
+        matched = true;
+    }
+    if (all || name == "stream") {
+        trafficStreamBenchmark(size > 0 ? size : 1000000);
+        matched = true;
+    }
+    return matched;
+}
+
+// ================ Routing Benchmark ================ //
+namespace {
+
+// Synthetic city: ~0.5 km blocks, two-way streets with random congestion.
+// Each direction is a road with its own road ID (1..count); returns the count.
+int buildGridCity(int gridSize, std::mt19937& rng, RoadNetwork& network) {
+    std::uniform_real_distribution<double> congestion(1.0, 2.0);
+    std::vector<Location> locations;
+    for (int r = 0; r < gridSize; r++) {
+        for (int c = 0; c < gridSize; c++) {
+            locations.emplace_back(r * gridSize + c, "grid", 40.60 + r * 0.0045, -74.10 + c * 0.006, "");
+        }
+    }
+
+    LocationIndex index;
+    index.build(locations);
+    network.setLocationIndex(index);
+    network.setNodes(locations);
+
+    int roads = 0;
+    auto connect = [&](int a, int b) {
+        double km = FileUtils::greatCircleDistance(locations[a].latitude, locations[a].longitude,
+                                                   locations[b].latitude, locations[b].longitude);
+        double there = km * congestion(rng);
+        double back = km * congestion(rng);
+        network.addEdge(a, b, there, EdgeMetrics{there, there, there}, ++roads);
+        network.addEdge(b, a, back, EdgeMetrics{back, back, back}, ++roads);
+    };
+    for (int r = 0; r < gridSize; r++) {
+        for (int c = 0; c < gridSize; c++) {
+            int u = r * gridSize + c;
+            if (c + 1 < gridSize) connect(u, u + 1);
+            if (r + 1 < gridSize) connect(u, u + gridSize);
+        }
+    }
+    network.finalize();
+    return roads;
+}
+
+}  // namespace
+
+void Benchmarks::routingBenchmark(int gridSize, int queries) {
+    std::cout << "\n[ROUTING BENCHMARK] " << gridSize << "x" << gridSize << " grid, "
+              << queries << " queries" << std::endl;
+
+    std::mt19937 rng(42);
+    RoadNetwork network;
+    buildGridCity(gridSize, rng, network);
+
+    std::uniform_int_distribution<int> pick(0, gridSize * gridSize - 1);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; i++) {
+        pairs.push_back({pick(rng), pick(rng)});
+    }
+
+    struct Mode { const char* name; SearchMode mode; };
+    const Mode modes[] = {
+        {"Dijkstra", SearchMode::Dijkstra},
+        {"Bidirectional", SearchMode::Bidirectional},
+        {"A*", SearchMode::AStar},
+    };
+
+    double baselineSettled = 0.0;
+    std::cout << "  " << std::left << std::setw(15) << "Mode"
+              << std::right << std::setw(15) << "Avg settled"
+              << std::setw(12) << "Avg us" << std::setw(12) << "Speedup" << std::endl;
+    for (const auto& mode : modes) {
+        long long settled = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [src, dest] : pairs) {
+            SearchStats stats;
+            network.shortestPathIndices(src, dest, mode.mode, &stats);
+            settled += stats.settledNodes;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(end - start).count() / queries;
+        double avgSettled = static_cast<double>(settled) / queries;
+        if (baselineSettled == 0.0) baselineSettled = avgSettled;
+
+        std::cout << "  " << std::left << std::setw(15) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(15) << avgSettled << std::setw(12) << micros
+                  << std::setw(11) << baselineSettled / avgSettled << "x" << std::endl;
+    }
+}
+
+// ================ Hash Table Benchmark ================ //
+namespace {
+
+// Milliseconds for each phase of one table type over the same keys
+template<typename Table>
+void timeHashTable(const char* name, const std::vector<int>& keys, const std::vector<int>& misses) {
+    using Clock = std::chrono::steady_clock;
+    auto millis = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    Table table;
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        table.insert(keys[i], static_cast<int>(i));
+    }
+    auto t1 = Clock::now();
+    long long found = 0;
+    int value = 0;
+    for (int key : keys) {
+        found += table.find(key, value);
+    }
+    auto t2 = Clock::now();
+    for (int key : misses) {
+        found += table.find(key, value);
+    }
+    auto t3 = Clock::now();
+    for (int key : keys) {
+        table.remove(key);
+    }
+    auto t4 = Clock::now();
+
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << millis(t0, t1) << std::setw(12)
+              << millis(t1, t2) << std::setw(12) << millis(t2, t3) << std::setw(12)
+              << millis(t3, t4) << std::endl;
+    if (found != static_cast<long long>(keys.size()) || !table.isEmpty()) {
+        std::cerr << "  " << name << ": inconsistent results" << std::endl;
+    }
+}
+
+// Latency of every single insert while the table grows from empty
+template<typename Table>
+void timeInsertLatency(const char* name, const std::vector<int>& keys) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> micros(keys.size());
+
+    Table table;
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto start = Clock::now();
+        table.insert(keys[i], static_cast<int>(i));
+        micros[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+    double total = 0.0;
+    for (double us : micros) total += us;
+    std::sort(micros.begin(), micros.end());
+    auto percentile = [&micros](double p) {
+        return micros[static_cast<size_t>(p * (micros.size() - 1))];
+    };
+
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << percentile(0.5) << std::setw(10)
+              << percentile(0.999) << std::setw(10) << percentile(0.99999) << std::setw(12)
+              << micros.back() << std::setw(12) << std::setprecision(1) << total / 1000.0
+              << std::endl;
+}
+
+// Distinct random keys, so no table benefits from a key pattern
+std::vector<int> distinctKeys(size_t count, std::mt19937& rng) {
+    std::vector<int> pool;
+    while (pool.size() < count) {
+        size_t missing = count - pool.size();
+        for (size_t i = 0; i < missing + missing / 8 + 16; i++) {
+            pool.push_back(static_cast<int>(rng()));
+        }
+        std::sort(pool.begin(), pool.end());
+        pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+    }
+    std::shuffle(pool.begin(), pool.end(), rng);
+    pool.resize(count);
+    return pool;
+}
+
+}  // namespace
+
+void Benchmarks::hashTableBenchmark(int entries) {
+    std::cout << "\n[HASH TABLE BENCHMARK] " << entries << " int keys (ms per phase)" << std::endl;
+
+    // Misses are random keys that were never inserted
+    std::mt19937 rng(42);
+    std::vector<int> pool = distinctKeys(2 * static_cast<size_t>(entries), rng);
+    std::vector<int> keys(pool.begin(), pool.begin() + entries);
+    std::vector<int> misses(pool.begin() + entries, pool.begin() + 2 * static_cast<size_t>(entries));
+
+    std::cout << "  " << std::left << std::setw(20) << "Policy" << std::right
+              << std::setw(12) << "Insert" << std::setw(12) << "Find hit"
+              << std::setw(12) << "Find miss" << std::setw(12) << "Remove" << std::endl;
+    timeHashTable<HashTable<int, int, SeparateChaining>>("Separate chaining", keys, misses);
+    timeHashTable<HashTable<int, int, IncrementalChaining>>("Incremental rehash", keys, misses);
+    timeHashTable<HashTable<int, int, OpenAddressing>>("Open addressing", keys, misses);
+}
+
+void Benchmarks::rehashLatencyBenchmark(int entries) {
+    std::cout << "\n[REHASH LATENCY BENCHMARK] " << entries
+              << " inserts into an empty table (us per insert)" << std::endl;
+
+    std::mt19937 rng(7);
+    std::vector<int> keys = distinctKeys(static_cast<size_t>(entries), rng);
+
+    std::cout << "  " << std::left << std::setw(22) << "Policy" << std::right
+              << std::setw(10) << "p50" << std::setw(10) << "p99.9" << std::setw(10)
+              << "p99.999" << std::setw(12) << "max" << std::setw(12) << "total ms" << std::endl;
+    timeInsertLatency<HashTable<int, int, SeparateChaining>>("Separate chaining", keys);
+    timeInsertLatency<HashTable<int, int, IncrementalChaining>>("Incremental rehash", keys);
+    timeInsertLatency<HashTable<int, int, OpenAddressing>>("Open addressing", keys);
+}
+
+// ================ Priority Queue Benchmark ================ //
+namespace {
+
+// Queued element shaped like a Delivery: an ordering key plus string fields
+struct Job {
+    uint64_t rank;
+    std::string id, source, destination;
+};
+struct JobBefore {
+    bool operator()(const Job& a, const Job& b) const { return a.rank < b.rank; }
+};
+struct JobAfter {   // std::priority_queue keeps the largest on top
+    bool operator()(const Job& a, const Job& b) const { return a.rank > b.rank; }
+};
+struct JobRank {
+    uint64_t operator()(const Job& job) const { return job.rank; }
+};
+
+void printHeapRow(const char* name, double pushMs, double popMs, bool ordered) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << pushMs << std::setw(12) << popMs
+              << std::endl;
+    if (!ordered) {
+        std::cerr << "  " << name << ": elements left out of order" << std::endl;
+    }
+}
+
+// Push every job under its index, then pop until empty
+template<typename Queue>
+void timeIndexedQueue(const char* name, const std::vector<Job>& jobs) {
+    using Clock = std::chrono::steady_clock;
+    Queue queue;
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < jobs.size(); i++) {
+        queue.push(static_cast<int>(i), jobs[i]);
+    }
+    auto t1 = Clock::now();
+    bool ordered = true;
+    uint64_t previous = 0;
+    while (!queue.empty()) {
+        Job job = queue.pop();
+        ordered = ordered && job.rank >= previous;
+        previous = job.rank;
+    }
+    auto t2 = Clock::now();
+    printHeapRow(name, std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                 std::chrono::duration<double, std::milli>(t2 - t1).count(), ordered);
+}
+
+}  // namespace
+
+void Benchmarks::priorityQueueBenchmark(int elements) {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n[PRIORITY QUEUE BENCHMARK] " << elements
+              << " delivery-sized elements (ms per phase)" << std::endl;
+
+    std::mt19937_64 rng(11);
+    std::vector<Job> jobs(elements);
+    for (int i = 0; i < elements; i++) {
+        jobs[i].rank = rng();
+        jobs[i].id = "D" + std::to_string(i);
+        jobs[i].source = "Loc" + std::to_string(rng() % 1000);
+        jobs[i].destination = "Loc" + std::to_string(rng() % 1000);
+    }
+
+    std::cout << "  " << std::left << std::setw(28) << "Queue" << std::right
+              << std::setw(12) << "Push" << std::setw(12) << "Pop all" << std::endl;
+    {
+        std::priority_queue<Job, std::vector<Job>, JobAfter> queue;
+        auto t0 = Clock::now();
+        for (const Job& job : jobs) {
+            queue.push(job);
+        }
+        auto t1 = Clock::now();
+        bool ordered = true;
+        uint64_t previous = 0;
+        while (!queue.empty()) {
+            ordered = ordered && queue.top().rank >= previous;
+            previous = queue.top().rank;
+            queue.pop();
+        }
+        auto t2 = Clock::now();
+        printHeapRow("std::priority_queue", std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                     std::chrono::duration<double, std::milli>(t2 - t1).count(), ordered);
+    }
+    timeIndexedQueue<PriorityQueue<int, Job, JobBefore, 2>>("Indexed binary heap", jobs);
+    timeIndexedQueue<PriorityQueue<int, Job, JobBefore, 4>>("Indexed 4-ary heap", jobs);
+    timeIndexedQueue<CompactPriorityQueue<int, Job, JobRank, 4>>("Indexed compact 4-ary heap", jobs);
+}
+
+// ================ Traffic Stream Benchmark ================ //
+void Benchmarks::trafficStreamBenchmark(int updates) {
+    const int gridSize = 300;
+    std::cout << "\n[TRAFFIC STREAM BENCHMARK] " << updates << " updates on a "
+              << gridSize << "x" << gridSize << " grid" << std::endl;
+
+    std::mt19937 rng(42);
+    RoadNetwork network;
+    int roads = buildGridCity(gridSize, rng, network);
+
+    // Update feed in the Traffic_updates.csv format, written up front
+    std::string path = (std::filesystem::temp_directory_path() / "smartcity_traffic_stream.csv").string();
+    {
+        std::ofstream feed(path, std::ios::trunc);
+        std::uniform_int_distribution<int> road(1, roads);
+        std::uniform_int_distribution<int> weight(1, 30);
+        feed << "road_id,new_weight,timestamp\n";
+        for (int i = 0; i < updates; i++) {
+            feed << road(rng) << "," << weight(rng) << ",2026-01-18T08:00:00\n";
+        }
+    }
+
+    // Route continuously while the stream applies batches underneath
+    TrafficStream stream(network);
+    std::uniform_int_distribution<int> pick(0, gridSize * gridSize - 1);
+    long long queries = 0;
+    auto start = std::chrono::steady_clock::now();
+    stream.start(path);
+    while (!stream.waitUntilIdle(0)) {
+        auto guard = stream.readLock();
+        network.shortestPathIndices(pick(rng), pick(rng), SearchMode::AStar);
+        queries++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stream.stop();
+    std::remove(path.c_str());
+
+    TrafficStreamStats stats = stream.getStats();
+    double batches = std::max<long long>(1, stats.batches);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  Ingested:   " << stats.updatesAccepted << " updates in " << seconds * 1000.0 << " ms ("
+              << std::setprecision(0) << stats.updatesAccepted / seconds << " updates/s)" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  Batches:    " << stats.batches << ", " << stats.coalesced << " updates coalesced, "
+              << stats.roadsApplied << " weights written" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "  Apply:      avg " << stats.totalApplyMs / batches << " ms, max "
+              << stats.maxApplyMs << " ms (graph write lock held)" << std::endl;
+    std::cout << "  Latency:    avg " << stats.totalLatencyMs / batches << " ms, max "
+              << stats.maxLatencyMs << " ms (received -> routable)" << std::endl;
+    std::cout << "  Concurrent: " << queries << " A* queries answered during ingestion" << std::endl;
+}
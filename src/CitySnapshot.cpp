@@ -0,0 +1,362 @@
+#include "CitySnapshot.hpp"
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+namespace {
+
+const uint32_t FILE_MAGIC = 0x50414E53;   // "SNAP"
+const uint32_t FILE_VERSION = 5;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sourceCount;
+    uint32_t sectionCount;
+};
+
+struct SectionEntry {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;   // from the start of the file, 8-byte aligned
+    uint64_t bytes;
+};
+
+// Fixed-size records; fields ordered so the structs have no padding
+struct LocationRecord {
+    double latitude, longitude;
+    StrRef name, details;
+    int32_t id;
+    uint32_t reserved;
+};
+
+struct VehicleRecord {
+    double capacity;
+    StrRef licensePlate, type, status;
+    int32_t id;
+    uint32_t reserved;
+};
+
+struct DeliveryRecord {
+    double weight;
+    int64_t deadlineEpoch;
+    StrRef id, source, destination, deadline, priority;
+    int32_t sourceId, destinationId;
+    uint32_t level;
+    uint32_t reserved;
+};
+
+struct TrafficRecord {
+    StrRef timestamp;
+    int32_t roadId;
+    int32_t newWeight;
+};
+
+struct RoadRecord {
+    double distance, congestion, time;
+    StrRef source, destination;
+    int32_t sourceId, destinationId;
+    int32_t roadId;
+    uint32_t reserved;
+};
+
+size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+}  // namespace
+
+// ================ Source Stamps ================ //
+std::vector<SourceStamp> stampSourceFiles(const std::vector<std::string>& paths) {
+    std::vector<SourceStamp> stamps;
+    for (const auto& path : paths) {
+        std::error_code error;
+        SourceStamp stamp{0, 0};
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (!error) {
+            stamp.size = size;
+            auto modified = std::filesystem::last_write_time(path, error);
+            if (!error) stamp.modified = modified.time_since_epoch().count();
+        }
+        stamps.push_back(stamp);
+    }
+    return stamps;
+}
+
+// ================ Snapshot Writer ================ //
+StrRef SnapshotWriter::addString(std::string_view text) {
+    // StrRef holds 32-bit offsets; a larger table is refused by save()
+    if (text.size() > UINT32_MAX - strings.size()) {
+        stringsOverflow = true;
+        return StrRef{0, 0};
+    }
+    StrRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size())};
+    strings.append(text);
+    return ref;
+}
+
+void SnapshotWriter::addSection(SnapshotSection id, const void* data, size_t bytes) {
+    sections.emplace_back(id, std::string(static_cast<const char*>(data), bytes));
+}
+
+void SnapshotWriter::add(const std::vector<Location>& locations) {
+    std::vector<LocationRecord> records(locations.size());
+    for (size_t i = 0; i < locations.size(); i++) {
+        const Location& loc = locations[i];
+        records[i] = {loc.latitude, loc.longitude, addString(loc.name), addString(loc.details), loc.id, 0};
+    }
+    addArray(SnapshotSection::Locations, records);
+}
+
+void SnapshotWriter::add(const std::vector<Vehicle>& vehicles) {
+    std::vector<VehicleRecord> records(vehicles.size());
+    for (size_t i = 0; i < vehicles.size(); i++) {
+        const Vehicle& vehicle = vehicles[i];
+        records[i] = {vehicle.capacity, addString(vehicle.licensePlate), addString(vehicle.type),
+                      addString(vehicle.status), vehicle.id, 0};
+    }
+    addArray(SnapshotSection::Vehicles, records);
+}
+
+void SnapshotWriter::add(const std::vector<Delivery>& deliveries) {
+    std::vector<DeliveryRecord> records(deliveries.size());
+    for (size_t i = 0; i < deliveries.size(); i++) {
+        const Delivery& delivery = deliveries[i];
+        records[i] = {delivery.weight, delivery.deadlineEpoch,
+                      addString(delivery.id), addString(delivery.source), addString(delivery.destination),
+                      addString(delivery.deadline), addString(delivery.priority),
+                      delivery.sourceId, delivery.destinationId,
+                      static_cast<uint32_t>(delivery.level), 0};
+    }
+    addArray(SnapshotSection::Deliveries, records);
+}
+
+void SnapshotWriter::add(const std::vector<TrafficEvent>& events) {
+    std::vector<TrafficRecord> records(events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        records[i] = {addString(events[i].timestamp), events[i].road_id, events[i].new_weight};
+    }
+    addArray(SnapshotSection::TrafficEvents, records);
+}
+
+void SnapshotWriter::add(const std::vector<Edge>& roads) {
+    std::vector<RoadRecord> records(roads.size());
+    for (size_t i = 0; i < roads.size(); i++) {
+        const Edge& road = roads[i];
+        records[i] = {road.distance, road.traffic_congestion, road.traffic_time,
+                      addString(road.source), addString(road.destination),
+                      road.sourceId, road.destinationId, road.road_id, 0};
+    }
+    addArray(SnapshotSection::Roads, records);
+}
+
+bool SnapshotWriter::save(const std::string& path, const std::vector<SourceStamp>& sources) const {
+    if (stringsOverflow) {
+        std::cerr << "Error writing snapshot: string table exceeds 4 GiB: " << path << std::endl;
+        return false;
+    }
+
+    // Section table first, so every offset is known before writing
+    std::vector<SectionEntry> table;
+    table.push_back({static_cast<uint32_t>(SnapshotSection::Strings), 0, 0, strings.size()});
+    for (const auto& [id, bytes] : sections) {
+        table.push_back({static_cast<uint32_t>(id), 0, 0, bytes.size()});
+    }
+    size_t offset = alignUp(sizeof(FileHeader) + sources.size() * sizeof(SourceStamp) +
+                            table.size() * sizeof(SectionEntry));
+    for (auto& entry : table) {
+        entry.offset = offset;
+        offset = alignUp(offset + entry.bytes);
+    }
+
+    // Write next to the target and rename, so readers never map a half-written file
+    std::string partial = path + ".tmp";
+    std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error writing snapshot: " << path << std::endl;
+        return false;
+    }
+    size_t written = 0;
+    auto write = [&file, &written](const void* data, size_t bytes) {
+        file.write(static_cast<const char*>(data), bytes);
+        written += bytes;
+    };
+    auto pad = [&write, &written]() {
+        static const char zeros[8] = {};
+        write(zeros, alignUp(written) - written);
+    };
+
+    FileHeader header{FILE_MAGIC, FILE_VERSION, static_cast<uint32_t>(sources.size()),
+                      static_cast<uint32_t>(table.size())};
+    write(&header, sizeof(header));
+    write(sources.data(), sources.size() * sizeof(SourceStamp));
+    write(table.data(), table.size() * sizeof(SectionEntry));
+    pad();
+    write(strings.data(), strings.size());
+    pad();
+    for (const auto& section : sections) {
+        write(section.second.data(), section.second.size());
+        pad();
+    }
+    file.close();
+    if (!file || std::rename(partial.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error writing snapshot: " << path << std::endl;
+        std::remove(partial.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ================ Snapshot Reader ================ //
+bool SnapshotReader::open(const std::string& path, const std::vector<SourceStamp>& sources) {
+    close();
+    if (!file.open(path)) return false;
+    std::string_view data = file.data();
+
+    // Header and stamps: same format version, same source files
+    FileHeader header;
+    if (data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    size_t tableStart = sizeof(header) + static_cast<size_t>(header.sourceCount) * sizeof(SourceStamp);
+    size_t tableEnd = tableStart + static_cast<size_t>(header.sectionCount) * sizeof(SectionEntry);
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+        header.sourceCount != sources.size() || data.size() < tableEnd) {
+        close();
+        return false;
+    }
+    for (size_t i = 0; i < sources.size(); i++) {
+        SourceStamp stamp;
+        std::memcpy(&stamp, data.data() + sizeof(header) + i * sizeof(SourceStamp), sizeof(stamp));
+        if (!(stamp == sources[i])) {
+            close();
+            return false;
+        }
+    }
+
+    // Section table: every section must lie inside the file
+    for (uint32_t i = 0; i < header.sectionCount; i++) {
+        SectionEntry entry;
+        std::memcpy(&entry, data.data() + tableStart + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.offset % 8 != 0 || entry.offset > data.size() || entry.bytes > data.size() - entry.offset) {
+            close();
+            return false;
+        }
+        sections.emplace_back(static_cast<SnapshotSection>(entry.id), data.substr(entry.offset, entry.bytes));
+    }
+    strings = section(SnapshotSection::Strings);
+    return true;
+}
+
+void SnapshotReader::close() {
+    file.close();
+    sections.clear();
+    strings = std::string_view();
+}
+
+std::string_view SnapshotReader::section(SnapshotSection id) const {
+    for (const auto& [sectionId, bytes] : sections) {
+        if (sectionId == id) return bytes;
+    }
+    return std::string_view();
+}
+
+bool SnapshotReader::string(const StrRef& ref, std::string& text) const {
+    if (ref.offset > strings.size() || ref.length > strings.size() - ref.offset) return false;
+    text.assign(strings.data() + ref.offset, ref.length);
+    return true;
+}
+
+bool SnapshotReader::read(std::vector<Location>& locations) const {
+    size_t count = 0;
+    const LocationRecord* records = view<LocationRecord>(SnapshotSection::Locations, count);
+    if (!records) return false;
+    locations.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const LocationRecord& record = records[i];
+        Location& loc = locations[i];
+        loc.id = record.id;
+        loc.latitude = record.latitude;
+        loc.longitude = record.longitude;
+        if (!string(record.name, loc.name) || !string(record.details, loc.details)) return false;
+    }
+    return true;
+}
+
+bool SnapshotReader::read(std::vector<Vehicle>& vehicles) const {
+    size_t count = 0;
+    const VehicleRecord* records = view<VehicleRecord>(SnapshotSection::Vehicles, count);
+    if (!records) return false;
+    vehicles.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const VehicleRecord& record = records[i];
+        Vehicle& vehicle = vehicles[i];
+        vehicle.id = record.id;
+        vehicle.capacity = record.capacity;
+        if (!string(record.licensePlate, vehicle.licensePlate) || !string(record.type, vehicle.type) ||
+            !string(record.status, vehicle.status)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SnapshotReader::read(std::vector<Delivery>& deliveries) const {
+    size_t count = 0;
+    const DeliveryRecord* records = view<DeliveryRecord>(SnapshotSection::Deliveries, count);
+    if (!records) return false;
+    deliveries.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const DeliveryRecord& record = records[i];
+        Delivery& delivery = deliveries[i];
+        delivery.weight = record.weight;
+        delivery.deadlineEpoch = record.deadlineEpoch;
+        delivery.sourceId = record.sourceId;
+        delivery.destinationId = record.destinationId;
+        delivery.level = static_cast<PriorityLevel>(record.level);
+        if (record.level < 1 || record.level > 3) return false;
+        if (!string(record.id, delivery.id) || !string(record.source, delivery.source) ||
+            !string(record.destination, delivery.destination) ||
+            !string(record.deadline, delivery.deadline) || !string(record.priority, delivery.priority)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SnapshotReader::read(std::vector<TrafficEvent>& events) const {
+    size_t count = 0;
+    const TrafficRecord* records = view<TrafficRecord>(SnapshotSection::TrafficEvents, count);
+    if (!records) return false;
+    events.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        events[i].road_id = records[i].roadId;
+        events[i].new_weight = records[i].newWeight;
+        if (!string(records[i].timestamp, events[i].timestamp)) return false;
+    }
+    return true;
+}
+
+bool SnapshotReader::read(std::vector<Edge>& roads) const {
+    size_t count = 0;
+    const RoadRecord* records = view<RoadRecord>(SnapshotSection::Roads, count);
+    if (!records) return false;
+    roads.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const RoadRecord& record = records[i];
+        Edge& road = roads[i];
+        road.distance = record.distance;
+        road.traffic_congestion = record.congestion;
+        road.traffic_time = record.time;
+        road.sourceId = record.sourceId;
+        road.destinationId = record.destinationId;
+        road.road_id = record.roadId;
+        if (!string(record.source, road.source) || !string(record.destination, road.destination)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SnapshotReader::fileSize() const {
+    return file.data().size();
+}
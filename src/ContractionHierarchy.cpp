@@ -0,0 +1,521 @@
+#include "ContractionHierarchy.hpp"
+#include <fstream>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+ContractionHierarchy::ContractionHierarchy()
+    : network(nullptr), networkFingerprint(0), networkVersion(0), shortcutCount(0) {}
+
+// ================ Preprocessing ================ //
+void ContractionHierarchy::build(const RoadNetwork& roadNetwork) {
+    const double INF = std::numeric_limits<double>::max();
+    network = &roadNetwork;
+    networkFingerprint = roadNetwork.fingerprint();
+    networkVersion = roadNetwork.getVersion();
+    shortcutCount = 0;
+
+    int n = roadNetwork.nodeCount();
+    std::vector<std::vector<Arc>> out(n), in(n);
+
+    // Insert or improve arc u -> v; parallel arcs collapse to the cheapest.
+    // Returns true only when a new arc was inserted
+    auto addArc = [&](int u, int v, double weight, int middle) {
+        for (auto& arc : out[u]) {
+            if (arc.node != v) continue;
+            if (weight < arc.weight) {
+                arc.weight = weight;
+                arc.middle = middle;
+                for (auto& back : in[v]) {
+                    if (back.node == u) {
+                        back.weight = weight;
+                        back.middle = middle;
+                        break;
+                    }
+                }
+            }
+            return false;
+        }
+        out[u].push_back({v, weight, middle});
+        in[v].push_back({u, weight, middle});
+        return true;
+    };
+
+    for (int u = 0; u < n; u++) {
+        for (int e = roadNetwork.edgeBegin(u); e < roadNetwork.edgeEnd(u); e++) {
+            int v = roadNetwork.edgeTarget(e);
+            if (v != u) addArc(u, v, roadNetwork.edgeWeight(e), -1);
+        }
+    }
+
+    std::vector<bool> contracted(n, false);
+    std::vector<int> deletedNeighbors(n, 0);
+
+    // Witness search workspace, reset through the touched list
+    std::vector<double> witnessDist(n, INF);
+    std::vector<int> touched;
+    typedef std::pair<double, int> QueueEntry;
+
+    // Bounded Dijkstra from source in the remaining graph, avoiding skip
+    auto witnessSearch = [&](int source, int skip, double maxDist) {
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+        witnessDist[source] = 0.0;
+        touched.push_back(source);
+        pq.push({0.0, source});
+        int settled = 0;
+        while (!pq.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > witnessDist[u]) continue;
+            if (d > maxDist) break;
+            settled++;
+            for (const auto& arc : out[u]) {
+                if (contracted[arc.node] || arc.node == skip) continue;
+                double nd = d + arc.weight;
+                if (nd < witnessDist[arc.node]) {
+                    if (witnessDist[arc.node] == INF) touched.push_back(arc.node);
+                    witnessDist[arc.node] = nd;
+                    pq.push({nd, arc.node});
+                }
+            }
+        }
+    };
+
+    // Shortcuts needed to contract v; when not simulating, only arcs that
+    // were actually inserted are counted
+    auto contract = [&](int v, bool simulate) {
+        int added = 0;
+        for (size_t i = 0; i < in[v].size(); i++) {
+            Arc incoming = in[v][i];
+            if (contracted[incoming.node]) continue;
+
+            double maxOut = 0.0;
+            for (const auto& outgoing : out[v]) {
+                if (!contracted[outgoing.node] && outgoing.node != incoming.node) {
+                    maxOut = std::max(maxOut, outgoing.weight);
+                }
+            }
+            witnessSearch(incoming.node, v, incoming.weight + maxOut);
+
+            for (size_t j = 0; j < out[v].size(); j++) {
+                Arc outgoing = out[v][j];
+                if (contracted[outgoing.node] || outgoing.node == incoming.node) continue;
+                double viaV = incoming.weight + outgoing.weight;
+                if (witnessDist[outgoing.node] > viaV) {
+                    if (simulate || addArc(incoming.node, outgoing.node, viaV, v)) added++;
+                }
+            }
+
+            for (int t : touched) witnessDist[t] = INF;
+            touched.clear();
+        }
+        return added;
+    };
+
+    // Importance: edge difference plus already contracted neighbors
+    auto priority = [&](int v) {
+        int degree = 0;
+        for (const auto& arc : in[v]) if (!contracted[arc.node]) degree++;
+        for (const auto& arc : out[v]) if (!contracted[arc.node]) degree++;
+        return contract(v, true) - degree + deletedNeighbors[v];
+    };
+
+    typedef std::pair<int, int> OrderEntry;
+    std::priority_queue<OrderEntry, std::vector<OrderEntry>, std::greater<OrderEntry>> order;
+    for (int v = 0; v < n; v++) {
+        order.push({priority(v), v});
+    }
+
+    // Lazy updates: re-evaluate the top node before contracting it
+    rank.assign(n, 0);
+    int nextRank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (contracted[v]) continue;
+
+        int current = priority(v);
+        if (!order.empty() && current > order.top().first) {
+            order.push({current, v});
+            continue;
+        }
+
+        shortcutCount += contract(v, false);
+        contracted[v] = true;
+        rank[v] = nextRank++;
+        for (const auto& arc : in[v]) deletedNeighbors[arc.node]++;
+        for (const auto& arc : out[v]) deletedNeighbors[arc.node]++;
+    }
+
+    // Split every arc into the upward graph of its lower-ranked endpoint
+    forwardOffsets.assign(n + 1, 0);
+    backwardOffsets.assign(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        for (const auto& arc : out[u]) {
+            if (rank[u] < rank[arc.node]) forwardOffsets[u + 1]++;
+            else backwardOffsets[arc.node + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        forwardOffsets[u + 1] += forwardOffsets[u];
+        backwardOffsets[u + 1] += backwardOffsets[u];
+    }
+
+    forwardArcs.assign(forwardOffsets[n], Arc{0, 0.0, -1});
+    backwardArcs.assign(backwardOffsets[n], Arc{0, 0.0, -1});
+    std::vector<int> forwardFill(forwardOffsets.begin(), forwardOffsets.end() - 1);
+    std::vector<int> backwardFill(backwardOffsets.begin(), backwardOffsets.end() - 1);
+    for (int u = 0; u < n; u++) {
+        for (const auto& arc : out[u]) {
+            if (rank[u] < rank[arc.node]) {
+                forwardArcs[forwardFill[u]++] = arc;
+            } else {
+                backwardArcs[backwardFill[arc.node]++] = Arc{u, arc.weight, arc.middle};
+            }
+        }
+    }
+}
+
+bool ContractionHierarchy::isBuilt() const {
+    return network != nullptr && !rank.empty();
+}
+
+bool ContractionHierarchy::isValidFor(const RoadNetwork& roadNetwork) const {
+    return isBuilt() && network == &roadNetwork &&
+           networkVersion == roadNetwork.getVersion();
+}
+
+int ContractionHierarchy::getShortcutCount() const {
+    return shortcutCount;
+}
+
+// ================ Serialization ================ //
+bool ContractionHierarchy::save(const std::string& path) const {
+    if (!isBuilt()) return false;
+    // Write next to the target and rename, so an interrupted save never leaves a half-written cache
+    std::string partial = path + ".tmp";
+    std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error writing contraction hierarchy: " << path << std::endl;
+        return false;
+    }
+
+    auto writeVector = [&file](const auto& values) {
+        uint64_t count = values.size();
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(values.data()), count * sizeof(values[0]));
+    };
+
+    // Arcs are written field by field so no padding bytes reach the file
+    auto writeArcs = [&file](const std::vector<Arc>& arcs) {
+        uint64_t count = arcs.size();
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& arc : arcs) {
+            int32_t node = arc.node, middle = arc.middle;
+            file.write(reinterpret_cast<const char*>(&node), sizeof(node));
+            file.write(reinterpret_cast<const char*>(&arc.weight), sizeof(arc.weight));
+            file.write(reinterpret_cast<const char*>(&middle), sizeof(middle));
+        }
+    };
+
+    uint32_t magic = FILE_MAGIC, version = FILE_VERSION;
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&networkFingerprint), sizeof(networkFingerprint));
+    file.write(reinterpret_cast<const char*>(&shortcutCount), sizeof(shortcutCount));
+    writeVector(rank);
+    writeVector(forwardOffsets);
+    writeArcs(forwardArcs);
+    writeVector(backwardOffsets);
+    writeArcs(backwardArcs);
+    file.close();
+    if (!file || std::rename(partial.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error writing contraction hierarchy: " << path << std::endl;
+        std::remove(partial.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ContractionHierarchy::load(const std::string& path, const RoadNetwork& roadNetwork) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    // Counts come from the file, so bound them before allocating: a corrupt
+    // body must fall back to a rebuild, not throw out of startup
+    auto readVector = [&file](auto& values, uint64_t maxCount) {
+        uint64_t count = 0;
+        if (!file.read(reinterpret_cast<char*>(&count), sizeof(count)) || count > maxCount) return false;
+        values.resize(count);
+        file.read(reinterpret_cast<char*>(values.data()), count * sizeof(values[0]));
+        return file.good();
+    };
+
+    auto readArcs = [&file, fileSize](std::vector<Arc>& arcs) {
+        const uint64_t arcBytes = sizeof(int32_t) + sizeof(double) + sizeof(int32_t);
+        uint64_t count = 0;
+        if (!file.read(reinterpret_cast<char*>(&count), sizeof(count))) return false;
+        uint64_t remaining = fileSize - static_cast<uint64_t>(file.tellg());
+        if (count > remaining / arcBytes) return false;
+        arcs.resize(count);
+        for (auto& arc : arcs) {
+            int32_t node = 0, middle = 0;
+            file.read(reinterpret_cast<char*>(&node), sizeof(node));
+            file.read(reinterpret_cast<char*>(&arc.weight), sizeof(arc.weight));
+            file.read(reinterpret_cast<char*>(&middle), sizeof(middle));
+            if (!file) return false;
+            arc.node = node;
+            arc.middle = middle;
+        }
+        return file.good();
+    };
+
+    uint32_t magic = 0, version = 0;
+    uint64_t fingerprint = 0;
+    int shortcuts = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    file.read(reinterpret_cast<char*>(&shortcuts), sizeof(shortcuts));
+    if (!file || magic != FILE_MAGIC || version != FILE_VERSION ||
+        fingerprint != roadNetwork.fingerprint()) {
+        return false;
+    }
+
+    size_t n = roadNetwork.nodeCount();
+    std::vector<int> loadedRank, fOffsets, bOffsets;
+    std::vector<Arc> fArcs, bArcs;
+    if (!readVector(loadedRank, n) || !readVector(fOffsets, n + 1) || !readArcs(fArcs) ||
+        !readVector(bOffsets, n + 1) || !readArcs(bArcs)) {
+        return false;
+    }
+    if (loadedRank.size() != n || fOffsets.size() != n + 1 || bOffsets.size() != n + 1) {
+        return false;
+    }
+
+    // Ranks must be a permutation so the upward graphs are well ordered
+    std::vector<bool> seen(n, false);
+    for (int r : loadedRank) {
+        if (r < 0 || static_cast<size_t>(r) >= n || seen[r]) return false;
+        seen[r] = true;
+    }
+
+    // Every arc points upward and every shortcut middle ranks below both
+    // endpoints, so unpacking always terminates
+    auto validGraph = [&](const std::vector<int>& offsets, const std::vector<Arc>& arcs) {
+        if (offsets[0] != 0 || static_cast<size_t>(offsets[n]) != arcs.size()) return false;
+        for (size_t u = 0; u < n; u++) {
+            if (offsets[u] > offsets[u + 1]) return false;
+            for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+                const Arc& arc = arcs[a];
+                if (arc.node < 0 || static_cast<size_t>(arc.node) >= n ||
+                    loadedRank[arc.node] <= loadedRank[u]) {
+                    return false;
+                }
+                if (arc.middle != -1 &&
+                    (arc.middle < 0 || static_cast<size_t>(arc.middle) >= n ||
+                     loadedRank[arc.middle] >= loadedRank[u])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    if (!validGraph(fOffsets, fArcs) || !validGraph(bOffsets, bArcs)) return false;
+
+    network = &roadNetwork;
+    networkFingerprint = fingerprint;
+    networkVersion = roadNetwork.getVersion();
+    shortcutCount = shortcuts;
+    rank.swap(loadedRank);
+    forwardOffsets.swap(fOffsets);
+    forwardArcs.swap(fArcs);
+    backwardOffsets.swap(bOffsets);
+    backwardArcs.swap(bArcs);
+    return true;
+}
+
+// ================ Query ================ //
+int ContractionHierarchy::findMiddle(int u, int v) const {
+    if (rank[u] < rank[v]) {
+        for (int a = forwardOffsets[u]; a < forwardOffsets[u + 1]; a++) {
+            if (forwardArcs[a].node == v) return forwardArcs[a].middle;
+        }
+    } else {
+        for (int a = backwardOffsets[v]; a < backwardOffsets[v + 1]; a++) {
+            if (backwardArcs[a].node == u) return backwardArcs[a].middle;
+        }
+    }
+    return -1;
+}
+
+void ContractionHierarchy::unpackArc(int u, int v, int middle, std::vector<int>& path) const {
+    if (middle == -1) {
+        path.push_back(v);
+        return;
+    }
+    unpackArc(u, middle, findMiddle(u, middle), path);
+    unpackArc(middle, v, findMiddle(middle, v), path);
+}
+
+std::vector<int> ContractionHierarchy::shortestPathIndices(int src, int dest, SearchStats* stats) const {
+    const double INF = std::numeric_limits<double>::max();
+    std::vector<int> path;
+    int n = static_cast<int>(rank.size());
+    if (!isBuilt() || src < 0 || dest < 0 || src >= n || dest >= n) {
+        return path;
+    }
+
+    std::vector<double> distF(n, INF), distB(n, INF);
+    std::vector<int> parentF(n, -1), parentB(n, -1);
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pqF, pqB;
+
+    distF[src] = 0.0;
+    distB[dest] = 0.0;
+    pqF.push({0.0, src});
+    pqB.push({0.0, dest});
+
+    double best = INF;
+    int meet = -1;
+    int settled = 0;
+
+    // Both searches only climb; stop once neither frontier can beat the best meeting
+    while (!pqF.empty() || !pqB.empty()) {
+        double topF = pqF.empty() ? INF : pqF.top().first;
+        double topB = pqB.empty() ? INF : pqB.top().first;
+        if (std::min(topF, topB) >= best) break;
+
+        bool forward = topF <= topB;
+        auto& pq = forward ? pqF : pqB;
+        auto& dist = forward ? distF : distB;
+        auto& other = forward ? distB : distF;
+        auto& parent = forward ? parentF : parentB;
+        const auto& offsets = forward ? forwardOffsets : backwardOffsets;
+        const auto& arcs = forward ? forwardArcs : backwardArcs;
+
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) continue;
+        settled++;
+
+        if (other[u] != INF && d + other[u] < best) {
+            best = d + other[u];
+            meet = u;
+        }
+
+        for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+            const Arc& arc = arcs[a];
+            double nd = d + arc.weight;
+            if (nd < dist[arc.node]) {
+                dist[arc.node] = nd;
+                parent[arc.node] = u;
+                pq.push({nd, arc.node});
+            }
+        }
+    }
+
+    if (stats) stats->settledNodes = settled;
+    if (meet == -1) return path;
+
+    // Hierarchy-level path: src .. meet .. dest
+    std::vector<int> chPath;
+    for (int v = meet; v != -1; v = parentF[v]) chPath.push_back(v);
+    std::reverse(chPath.begin(), chPath.end());
+    for (int v = parentB[meet]; v != -1; v = parentB[v]) chPath.push_back(v);
+
+    // Replace every shortcut by the roads it stands for
+    path.push_back(chPath[0]);
+    for (size_t i = 0; i + 1 < chPath.size(); i++) {
+        unpackArc(chPath[i], chPath[i + 1], findMiddle(chPath[i], chPath[i + 1]), path);
+    }
+    return path;
+}
+
+std::vector<int> ContractionHierarchy::shortestPath(int source, int destination, SearchStats* stats) const {
+    if (!isBuilt()) return {};
+    const LocationIndex& index = network->getLocationIndex();
+    std::vector<int> path = shortestPathIndices(index.toIndex(source), index.toIndex(destination), stats);
+    for (auto& node : path) {
+        node = index.toId(node);
+    }
+    return path;
+}
+
+// ================ Many-to-Many ================ //
+template<typename Visitor>
+void ContractionHierarchy::upwardSearch(int start, bool forward, std::vector<double>& dist,
+                                        std::vector<int>& touched, Visitor visit) const {
+    const double INF = std::numeric_limits<double>::max();
+    const auto& offsets = forward ? forwardOffsets : backwardOffsets;
+    const auto& arcs = forward ? forwardArcs : backwardArcs;
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+
+    dist[start] = 0.0;
+    touched.push_back(start);
+    pq.push({0.0, start});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) continue;
+        visit(u, d);
+        for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+            const Arc& arc = arcs[a];
+            double nd = d + arc.weight;
+            if (nd < dist[arc.node]) {
+                if (dist[arc.node] == INF) touched.push_back(arc.node);
+                dist[arc.node] = nd;
+                pq.push({nd, arc.node});
+            }
+        }
+    }
+
+    // Leave the workspace clean for the next search
+    for (int t : touched) dist[t] = INF;
+    touched.clear();
+}
+
+void ContractionHierarchy::fillDistanceMatrix(const std::vector<int>& sources,
+                                              const std::vector<int>& destinations,
+                                              DistanceMatrix& matrix) const {
+    const double INF = std::numeric_limits<double>::max();
+    int n = static_cast<int>(rank.size());
+    matrix.rows = static_cast<int>(sources.size());
+    matrix.cols = static_cast<int>(destinations.size());
+    matrix.costs.assign(static_cast<size_t>(matrix.rows) * matrix.cols, INF);
+    if (!isBuilt()) return;
+
+    std::vector<double> dist(n, INF);
+    std::vector<int> touched;
+
+    // Bucket entry: (column, distance from the bucket node to that destination)
+    std::vector<std::vector<std::pair<int, double>>> buckets(n);
+    std::vector<int> usedBuckets;
+    for (int c = 0; c < matrix.cols; c++) {
+        int t = destinations[c];
+        if (t < 0 || t >= n) continue;
+        upwardSearch(t, false, dist, touched, [&](int v, double d) {
+            if (buckets[v].empty()) usedBuckets.push_back(v);
+            buckets[v].push_back({c, d});
+        });
+    }
+
+    for (int r = 0; r < matrix.rows; r++) {
+        int s = sources[r];
+        if (s < 0 || s >= n) continue;
+        double* row = matrix.costs.data() + static_cast<size_t>(r) * matrix.cols;
+        upwardSearch(s, true, dist, touched, [&](int u, double d) {
+            for (const auto& [c, toDest] : buckets[u]) {
+                row[c] = std::min(row[c], d + toDest);
+            }
+        });
+    }
+
+    for (int v : usedBuckets) buckets[v].clear();
+}
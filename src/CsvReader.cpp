@@ -0,0 +1,152 @@
+#include "CsvReader.hpp"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ================ Mapped File ================ //
+MappedFile::MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        // Nothing to map; an empty view is still a successfully opened file
+        ::close(fd);
+        bytes = "";
+        return true;
+    }
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping keeps the file alive
+    if (address != MAP_FAILED) {
+        madvise(address, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(address);
+        mapped = true;
+        return true;
+    }
+    length = 0;
+#endif
+    // No mmap: read the whole file into one buffer
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool MappedFile::isOpen() const {
+    return bytes != nullptr;
+}
+
+std::string_view MappedFile::data() const {
+    return bytes ? std::string_view(bytes, length) : std::string_view();
+}
+
+// ================ CSV Reader ================ //
+CsvReader::CsvReader(std::string_view text) : text(text), position(0), rowNumber(0) {}
+
+bool CsvReader::nextRow(std::vector<std::string_view>& fields) {
+    fields.clear();
+    if (position >= text.size()) return false;
+
+    // Row extent: up to the next '\n' (memchr scans a word or vector at a time)
+    const char* start = text.data() + position;
+    size_t remaining = text.size() - position;
+    const char* newline = static_cast<const char*>(std::memchr(start, '\n', remaining));
+    size_t rowLength = newline ? static_cast<size_t>(newline - start) : remaining;
+    row = std::string_view(start, rowLength);
+    position += rowLength + (newline ? 1 : 0);
+    rowNumber++;
+
+    // Fields: split on ',' within the row
+    const char* cursor = row.data();
+    const char* end = row.data() + row.size();
+    while (true) {
+        const char* comma = static_cast<const char*>(
+            std::memchr(cursor, ',', static_cast<size_t>(end - cursor)));
+        const char* fieldEnd = comma ? comma : end;
+        fields.push_back(trim(std::string_view(cursor, static_cast<size_t>(fieldEnd - cursor))));
+        if (!comma) break;
+        cursor = comma + 1;
+    }
+    return true;
+}
+
+std::string_view CsvReader::line() const {
+    return trim(row);
+}
+
+long long CsvReader::lineNumber() const {
+    return rowNumber;
+}
+
+size_t CsvReader::countRows(std::string_view text) {
+    size_t rows = 0;
+    const char* cursor = text.data();
+    const char* end = text.data() + text.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        rows++;
+        if (!newline) break;
+        cursor = newline + 1;
+    }
+    return rows;
+}
+
+std::string_view CsvReader::trim(std::string_view field) {
+    // Fields are short and mostly untrimmed: check the ends without branching
+    // on character classes (a byte <= ' ' is blank for CSV purposes)
+    size_t begin = 0, end = field.size();
+    while (begin < end && static_cast<unsigned char>(field[begin]) <= ' ') begin++;
+    while (end > begin && static_cast<unsigned char>(field[end - 1]) <= ' ') end--;
+    return field.substr(begin, end - begin);
+}
+
+bool CsvReader::parseInt(std::string_view field, int& value) {
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    const char* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, value);
+    return !field.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+bool CsvReader::parseDouble(std::string_view field, double& value) {
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    const char* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, value);
+    return !field.empty() && result.ec == std::errc() && result.ptr == end;
+}
@@ -3,13 +3,90 @@
 #include <iostream>
 #include <iomanip>
 
+// ==================== Route Cache ====================
+
+RouteCache::RouteCache(size_t capacity) : capacity(capacity), graphVersion(0) {}
+
+void RouteCache::syncVersion(uint64_t version) {
+    if (version == graphVersion) return;
+    if (!entries.empty()) stats.invalidations++;
+    entries.clear();
+    lookup.clear();
+    graphVersion = version;
+}
+
+bool RouteCache::get(int source, int destination, int profile, uint64_t version,
+                     std::vector<int>& route) {
+    syncVersion(version);
+    auto it = lookup.find(Key{source, destination, profile});
+    if (it == lookup.end()) {
+        stats.misses++;
+        return false;
+    }
+    // Move to the front: most recently used
+    entries.splice(entries.begin(), entries, it->second);
+    route = it->second->route;
+    stats.hits++;
+    return true;
+}
+
+void RouteCache::put(int source, int destination, int profile, uint64_t version,
+                     const std::vector<int>& route) {
+    if (capacity == 0) return;
+    syncVersion(version);
+    Key key{source, destination, profile};
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        it->second->route = route;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    
+    // Evict the least recently used entry when full
+    if (entries.size() >= capacity) {
+        lookup.erase(entries.back().key);
+        entries.pop_back();
+        stats.evictions++;
+    }
+    entries.push_front(Entry{key, route});
+    lookup[key] = entries.begin();
+}
+
+void RouteCache::clear() {
+    entries.clear();
+    lookup.clear();
+}
+
+size_t RouteCache::size() const {
+    return entries.size();
+}
+
+const RouteCacheStats& RouteCache::getStats() const {
+    return stats;
+}
+
+// ==================== Delivery Scheduler ====================
+
 // Add new delivery to the priority queue
 void DeliveryScheduler::addDelivery(const Delivery& delivery) {
-    pendingDeliveries.push(delivery);
+    pendingDeliveries.push(delivery.id, delivery);
     std::cout << "Delivery added: " << delivery.id 
               << " (Priority: " << delivery.priority << ")" << std::endl;
 }
 
+int DeliveryScheduler::addDeliveries(const std::vector<Delivery>& deliveries) {
+    int added = 0;
+    for (const auto& delivery : deliveries) {
+        if (pendingDeliveries.push(delivery.id, delivery)) added++;
+    }
+    return added;
+}
+
+// Use a preprocessed hierarchy for route calculation
+void DeliveryScheduler::setContractionHierarchy(const ContractionHierarchy* ch) {
+    hierarchy = ch;
+}
+
 // Get next highest priority delivery
 Delivery DeliveryScheduler::getNextDelivery() {
     if (pendingDeliveries.empty()) {
@@ -21,25 +98,40 @@ Delivery DeliveryScheduler::getNextDelivery() {
 // Calculate optimal route between source and destination
 std::vector<int> DeliveryScheduler::calculateOptimalRoute(const std::string& source, 
                                                           const std::string& destination,
-                                                          const std::vector<Location>& locations) {
+                                                          const std::vector<Location>& locations,
+                                                          const WeightProfile& profile) {
+    // Find location IDs for source and destination (interned names, O(1))
+    return calculateOptimalRoute(roadNetwork->getLocationIdByName(source, locations),
+                                 roadNetwork->getLocationIdByName(destination, locations), profile);
+}
+
+std::vector<int> DeliveryScheduler::calculateOptimalRoute(int sourceId, int destId,
+                                                          const WeightProfile& profile) {
     std::vector<int> route;
     
-    // Find location IDs for source and destination
-    int sourceId = -1, destId = -1;
-    
-    for (const auto& loc : locations) {
-        if (loc.name == source) sourceId = loc.id;
-        if (loc.name == destination) destId = loc.id;
-    }
-    
     if (sourceId == -1 || destId == -1) {
         std::cerr << "Invalid source or destination location" << std::endl;
         return route;
     }
     
-    // Use road network to find shortest path
+    // Repeated source/destination pairs are served from the cache; ad-hoc
+    // custom profiles have no stable key and are never cached
+    uint64_t version = roadNetwork->getVersion();
+    bool cacheable = profile.id >= 0;
+    if (cacheable && routeCache.get(sourceId, destId, profile.id, version, route)) {
+        return route;
+    }
+    
+    // Use the hierarchy when it matches the graph, otherwise goal-directed search
     try {
-        route = roadNetwork->shortestPath(sourceId, destId);
+        if (profile.live && hierarchy && hierarchy->isValidFor(*roadNetwork)) {
+            route = hierarchy->shortestPath(sourceId, destId);
+        } else {
+            route = roadNetwork->shortestPath(sourceId, destId, SearchMode::AStar, nullptr, profile);
+        }
+        if (cacheable && !route.empty()) {
+            routeCache.put(sourceId, destId, profile.id, version, route);
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error calculating route: " << e.what() << std::endl;
         // Fallback: direct route
@@ -49,6 +141,54 @@ std::vector<int> DeliveryScheduler::calculateOptimalRoute(const std::string& sou
     return route;
 }
 
+// Route a batch of deliveries; only the cache misses reach the worker pool
+std::vector<std::vector<int>> DeliveryScheduler::calculateOptimalRoutes(const std::vector<Delivery>& deliveries,
+                                                                        const std::vector<Location>& locations,
+                                                                        ThreadPool& pool,
+                                                                        const WeightProfile& profile) {
+    std::vector<std::vector<int>> routes(deliveries.size());
+    
+    uint64_t version = roadNetwork->getVersion();
+    bool cacheable = profile.id >= 0;
+    std::vector<std::pair<int, int>> queries;
+    std::vector<size_t> queryOwner;
+    for (size_t i = 0; i < deliveries.size(); i++) {
+        int src = sourceOf(deliveries[i], locations);
+        int dest = destinationOf(deliveries[i], locations);
+        if (src == -1 || dest == -1) {
+            std::cerr << "Invalid source or destination location" << std::endl;
+            continue;
+        }
+        if (!cacheable || !routeCache.get(src, dest, profile.id, version, routes[i])) {
+            queries.push_back({src, dest});
+            queryOwner.push_back(i);
+        }
+    }
+    
+    // Same strategy as calculateOptimalRoute: hierarchy if valid, else A*
+    std::vector<std::vector<int>> found =
+        roadNetwork->shortestPaths(queries, pool, SearchMode::AStar, hierarchy, profile);
+    for (size_t q = 0; q < queries.size(); q++) {
+        if (cacheable && !found[q].empty()) {
+            routeCache.put(queries[q].first, queries[q].second, profile.id, version, found[q]);
+        }
+        routes[queryOwner[q]] = std::move(found[q]);
+    }
+    
+    return routes;
+}
+
+// Endpoints resolved at load, or by name for deliveries built elsewhere
+int DeliveryScheduler::sourceOf(const Delivery& delivery, const std::vector<Location>& locations) const {
+    return delivery.sourceId != -1 ? delivery.sourceId
+                                   : roadNetwork->getLocationIdByName(delivery.source, locations);
+}
+
+int DeliveryScheduler::destinationOf(const Delivery& delivery, const std::vector<Location>& locations) const {
+    return delivery.destinationId != -1 ? delivery.destinationId
+                                        : roadNetwork->getLocationIdByName(delivery.destination, locations);
+}
+
 // Calculate estimated delivery time for a route
 double DeliveryScheduler::calculateEstimatedTime(const std::vector<int>& route) {
     double totalTime = 0.0;
@@ -64,87 +204,126 @@ bool DeliveryScheduler::assignDeliveryToVehicle(const std::string& deliveryId,
                                                  int vehicleId,
                                                  const std::vector<Vehicle>& vehicles,
                                                  const std::vector<Location>& locations) {
-    // Find the delivery in pending queue
-    if (pendingDeliveries.empty()) {
-        // Silently return if no pending deliveries
-        return false;
-    }
-    
-    // Get the delivery
-    Delivery delivery = pendingDeliveries.pop();
-    
-    if (delivery.id != deliveryId) {
-        // Silently re-add delivery if ID mismatch
-        pendingDeliveries.push(delivery);
+    return assignWithRoute(deliveryId, vehicleId, vehicles, locations, nullptr);
+}
+
+bool DeliveryScheduler::assignDeliveryToVehicle(const std::string& deliveryId,
+                                                 int vehicleId,
+                                                 const std::vector<Vehicle>& vehicles,
+                                                 const std::vector<Location>& locations,
+                                                 const std::vector<int>& route) {
+    return assignWithRoute(deliveryId, vehicleId, vehicles, locations, &route);
+}
+
+bool DeliveryScheduler::assignWithRoute(const std::string& deliveryId,
+                                        int vehicleId,
+                                        const std::vector<Vehicle>& vehicles,
+                                        const std::vector<Location>& locations,
+                                        const std::vector<int>* precomputed) {
+    // Find the delivery in pending queue; it stays queued until assigned
+    const Delivery* pending = pendingDeliveries.find(deliveryId);
+    if (!pending) {
+        // Silently return if the delivery is not pending
         return false;
     }
+    const Delivery& delivery = *pending;
     
     // Find vehicle
-    Vehicle* assignedVehicle = nullptr;
+    const Vehicle* assignedVehicle = nullptr;
     for (const auto& v : vehicles) {
         if (v.id == vehicleId) {
-            assignedVehicle = const_cast<Vehicle*>(&v);
+            assignedVehicle = &v;
             break;
         }
     }
     
-    if (!assignedVehicle) {
-        // Silently re-add delivery if vehicle not found
-        pendingDeliveries.push(delivery);
-        return false;
-    }
-    
-    // Check capacity
-    if (!hasCapacity(*assignedVehicle, delivery)) {
-        // Silently re-add if capacity insufficient
-        pendingDeliveries.push(delivery);
+    // Silently fail if vehicle not found or capacity insufficient
+    if (!assignedVehicle || !hasCapacity(*assignedVehicle, delivery)) {
         return false;
     }
     
-    // Calculate route
-    std::vector<int> route = calculateOptimalRoute(delivery.source, delivery.destination, locations);
+    // Calculate route unless the caller already did
+    std::vector<int> route = precomputed ? *precomputed
+        : calculateOptimalRoute(sourceOf(delivery, locations), destinationOf(delivery, locations));
     
     if (route.empty()) {
-        // Silently re-add if route cannot be calculated
-        pendingDeliveries.push(delivery);
+        // Silently fail if route cannot be calculated
         return false;
     }
+    pendingDeliveries.erase(deliveryId);
     
     // Create assignment record
     DeliveryAssignment assignment;
     assignment.deliveryId = deliveryId;
     assignment.vehicleId = vehicleId;
-    assignment.route = route;
     assignment.estimatedTime = calculateEstimatedTime(route);
+    assignment.route = std::move(route);
     assignment.status = "in-transit";
+    double estimatedTime = assignment.estimatedTime;
     
-    // Store assignment
-    assignedDeliveries.insert(deliveryId, assignment);
+    // Store assignment (moved in, the route is not copied)
+    assignedDeliveries.insert_or_assign(deliveryId, std::move(assignment));
     
-    // Add to vehicle's delivery list
-    std::vector<std::string> vehicleDeliv;
-    if (!vehicleDeliveries.find(vehicleId, vehicleDeliv)) {
-        vehicleDeliv.clear();
-    }
-    vehicleDeliv.push_back(deliveryId);
-    vehicleDeliveries.insert(vehicleId, vehicleDeliv);
+    // Append to the vehicle's delivery list in place, as one atomic step
+    vehicleDeliveries.upsert(vehicleId, [&deliveryId](std::vector<std::string>& deliveries) {
+        deliveries.push_back(deliveryId);
+    });
     
     std::cout << "Delivery " << deliveryId << " assigned to vehicle " << vehicleId 
-              << " with estimated time: " << assignment.estimatedTime << " minutes" << std::endl;
+              << " with estimated time: " << estimatedTime << " minutes" << std::endl;
     
     return true;
 }
 
+// Match deliveries to vehicles by road cost from each vehicle's start
+std::vector<int> DeliveryScheduler::matchVehicles(const std::vector<Delivery>& deliveries,
+                                                  const std::vector<Vehicle>& vehicles,
+                                                  const std::vector<Location>& locations) {
+    std::vector<int> matches(deliveries.size(), -1);
+    
+    // Rows: vehicle start locations (stored in licensePlate), columns: pickups
+    std::vector<int> starts, pickups;
+    for (const auto& v : vehicles) {
+        starts.push_back(roadNetwork->getLocationIdByName(v.licensePlate, locations));
+    }
+    for (const auto& d : deliveries) {
+        pickups.push_back(sourceOf(d, locations));
+    }
+    DistanceMatrix costs = roadNetwork->distanceMatrix(starts, pickups, hierarchy);
+    
+    // Greedy in delivery order: each vehicle takes at most one delivery
+    std::vector<bool> used(vehicles.size(), false);
+    for (size_t c = 0; c < deliveries.size(); c++) {
+        int best = -1;
+        for (size_t r = 0; r < vehicles.size(); r++) {
+            if (used[r] || !hasCapacity(vehicles[r], deliveries[c]) || !costs.reachable(r, c)) continue;
+            if (best == -1 || costs.cost(r, c) < costs.cost(best, c)) best = r;
+        }
+        if (best != -1) {
+            used[best] = true;
+            matches[c] = vehicles[best].id;
+        }
+    }
+    
+    return matches;
+}
+
 // Reassign delivery (when priority changes)
 void DeliveryScheduler::reassignDelivery(const std::string& deliveryId, 
                                          const Delivery& updatedDelivery) {
-    // Remove current assignment
-    DeliveryAssignment* current = getAssignment(deliveryId);
-    if (current) {
-        current->status = "reassigned";
+    // Still pending: reorder in place under the new priority
+    if (pendingDeliveries.update(deliveryId, updatedDelivery)) {
+        std::cout << "Delivery " << deliveryId << " reprioritized to: "
+                  << updatedDelivery.priority << std::endl;
+        return;
     }
     
-    addDelivery(updatedDelivery);
+    // Remove current assignment
+    assignedDeliveries.update(deliveryId, [](DeliveryAssignment& current) {
+        current.status = "reassigned";
+    });
+    
+    pendingDeliveries.push(deliveryId, updatedDelivery);
     
     std::cout << "Delivery " << deliveryId << " reassigned with new priority: " 
               << updatedDelivery.priority << std::endl;
@@ -152,36 +331,39 @@ void DeliveryScheduler::reassignDelivery(const std::string& deliveryId,
 
 // Mark delivery as completed
 void DeliveryScheduler::completeDelivery(const std::string& deliveryId) {
-    DeliveryAssignment* assignment = getAssignment(deliveryId);
-    if (assignment) {
-        assignment->status = "completed";
+    bool found = assignedDeliveries.update(deliveryId, [](DeliveryAssignment& assignment) {
+        assignment.status = "completed";
+    });
+    if (found) {
         std::cout << "Delivery " << deliveryId << " marked as completed" << std::endl;
     } else {
         std::cerr << "Delivery not found: " << deliveryId << std::endl;
     }
 }
 
-// Get assignment details
-DeliveryAssignment* DeliveryScheduler::getAssignment(const std::string& deliveryId) {
-    DeliveryAssignment dummy;
-    if (assignedDeliveries.find(deliveryId, dummy)) {
-        static DeliveryAssignment lastFound;
-        lastFound = dummy;
-        return &lastFound;
-    }
-    return nullptr;
+// Get assignment details (a copy, the stored record may change concurrently)
+bool DeliveryScheduler::getAssignment(std::string_view deliveryId, DeliveryAssignment& assignment) const {
+    return assignedDeliveries.find(deliveryId, assignment);
 }
 
-std::vector<std::string> DeliveryScheduler::getVehicleDeliveries(int vehicleId) {
+std::vector<std::string> DeliveryScheduler::getVehicleDeliveries(int vehicleId) const {
     std::vector<std::string> deliveries;
     vehicleDeliveries.find(vehicleId, deliveries);
     return deliveries;
 }
 
+const RouteCacheStats& DeliveryScheduler::getRouteCacheStats() const {
+    return routeCache.getStats();
+}
+
 int DeliveryScheduler::getPendingCount() const {
     return pendingDeliveries.size();
 }
 
+bool DeliveryScheduler::isPending(std::string_view deliveryId) const {
+    return pendingDeliveries.contains(deliveryId);
+}
+
 // Display all pending deliveries
 void DeliveryScheduler::displayPendingDeliveries() const {
     std::cout << "\n===== Pending Deliveries =====" << std::endl;
@@ -0,0 +1,200 @@
+#include "DynamicShortestPaths.hpp"
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+DynamicShortestPaths::DynamicShortestPaths(RoadNetwork* network)
+    : network(network), layoutVersion(network->getLayoutVersion()), lastRepairedNodes(0) {}
+
+// ================ Tree Management ================ //
+void DynamicShortestPaths::addRoot(int locationId) {
+    int root = network->getLocationIndex().toIndex(locationId);
+    if (root < 0 || root >= network->nodeCount() || findTree(locationId)) return;
+
+    Tree tree;
+    tree.root = root;
+    rebuild(tree);
+    trees.push_back(std::move(tree));
+}
+
+int DynamicShortestPaths::rootCount() const {
+    return static_cast<int>(trees.size());
+}
+
+const DynamicShortestPaths::Tree* DynamicShortestPaths::findTree(int rootId) const {
+    int root = network->getLocationIndex().toIndex(rootId);
+    for (const auto& tree : trees) {
+        if (tree.root == root) return &tree;
+    }
+    return nullptr;
+}
+
+void DynamicShortestPaths::rebuild(Tree& tree) {
+    const double INF = std::numeric_limits<double>::max();
+    int n = network->nodeCount();
+    tree.dist.assign(n, INF);
+    tree.parentEdge.assign(n, -1);
+
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+    tree.dist[tree.root] = 0.0;
+    pq.push({0.0, tree.root});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > tree.dist[u]) continue;
+        for (int e = network->edgeBegin(u); e < network->edgeEnd(u); e++) {
+            int v = network->edgeTarget(e);
+            double nd = d + network->edgeWeight(e);
+            if (nd < tree.dist[v]) {
+                tree.dist[v] = nd;
+                tree.parentEdge[v] = e;
+                pq.push({nd, v});
+            }
+        }
+    }
+}
+
+// ================ Incremental Repair ================ //
+int DynamicShortestPaths::repair(Tree& tree, const std::vector<int>& changed) {
+    const double INF = std::numeric_limits<double>::max();
+    std::vector<int> invalidRoots;
+
+    // Tree edges that became more expensive cut off their subtree
+    // (distances still reflect the old weights at this point)
+    for (int e : changed) {
+        int u = network->edgeSource(e);
+        int v = network->edgeTarget(e);
+        if (tree.parentEdge[v] == e && tree.dist[u] + network->edgeWeight(e) > tree.dist[v]) {
+            invalidRoots.push_back(v);
+        }
+    }
+
+    // Collect the affected subtrees by walking tree edges downwards
+    std::vector<int> affected;
+    std::vector<bool> inAffected(tree.dist.size(), false);
+    for (int v : invalidRoots) {
+        if (inAffected[v]) continue;
+        inAffected[v] = true;
+        affected.push_back(v);
+    }
+    for (size_t i = 0; i < affected.size(); i++) {
+        int a = affected[i];
+        for (int e = network->edgeBegin(a); e < network->edgeEnd(a); e++) {
+            int x = network->edgeTarget(e);
+            if (!inAffected[x] && tree.parentEdge[x] == e) {
+                inAffected[x] = true;
+                affected.push_back(x);
+            }
+        }
+    }
+    for (int a : affected) {
+        tree.dist[a] = INF;
+        tree.parentEdge[a] = -1;
+    }
+
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+
+    // Re-seed invalidated nodes from their best unaffected in-neighbor
+    for (int a : affected) {
+        for (int i = network->reverseBegin(a); i < network->reverseEnd(a); i++) {
+            int y = network->reverseSource(i);
+            int e = network->reverseEdge(i);
+            if (inAffected[y] || tree.dist[y] == INF) continue;
+            double nd = tree.dist[y] + network->edgeWeight(e);
+            if (nd < tree.dist[a]) {
+                tree.dist[a] = nd;
+                tree.parentEdge[a] = e;
+            }
+        }
+        if (tree.dist[a] != INF) pq.push({tree.dist[a], a});
+    }
+
+    // Cheaper edges improve their head directly
+    for (int e : changed) {
+        int u = network->edgeSource(e);
+        int v = network->edgeTarget(e);
+        if (tree.dist[u] == INF) continue;
+        double nd = tree.dist[u] + network->edgeWeight(e);
+        if (nd < tree.dist[v]) {
+            tree.dist[v] = nd;
+            tree.parentEdge[v] = e;
+            pq.push({nd, v});
+        }
+    }
+
+    // Settle only what the seeds reach
+    int settled = 0;
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > tree.dist[u]) continue;
+        settled++;
+        for (int e = network->edgeBegin(u); e < network->edgeEnd(u); e++) {
+            int v = network->edgeTarget(e);
+            double nd = d + network->edgeWeight(e);
+            if (nd < tree.dist[v]) {
+                tree.dist[v] = nd;
+                tree.parentEdge[v] = e;
+                pq.push({nd, v});
+            }
+        }
+    }
+    return settled;
+}
+
+void DynamicShortestPaths::refresh() {
+    std::vector<int> changed = network->takeChangedEdges();
+    lastRepairedNodes = 0;
+
+    // Re-finalized graph: edge slots moved, start over
+    if (layoutVersion != network->getLayoutVersion()) {
+        layoutVersion = network->getLayoutVersion();
+        for (auto& tree : trees) {
+            rebuild(tree);
+            lastRepairedNodes += network->nodeCount();
+        }
+        return;
+    }
+
+    if (changed.empty()) return;
+    for (auto& tree : trees) {
+        lastRepairedNodes += repair(tree, changed);
+    }
+}
+
+int DynamicShortestPaths::getLastRepairedNodes() const {
+    return lastRepairedNodes;
+}
+
+// ================ Queries ================ //
+double DynamicShortestPaths::distance(int rootId, int locationId) const {
+    const Tree* tree = findTree(rootId);
+    int v = network->getLocationIndex().toIndex(locationId);
+    if (!tree || v < 0 || v >= static_cast<int>(tree->dist.size())) {
+        return std::numeric_limits<double>::max();
+    }
+    return tree->dist[v];
+}
+
+std::vector<int> DynamicShortestPaths::path(int rootId, int locationId) const {
+    std::vector<int> result;
+    const Tree* tree = findTree(rootId);
+    int v = network->getLocationIndex().toIndex(locationId);
+    if (!tree || v < 0 || v >= static_cast<int>(tree->dist.size()) ||
+        tree->dist[v] == std::numeric_limits<double>::max()) {
+        return result;
+    }
+
+    // Walk parent edges back to the root, then convert to location IDs
+    const LocationIndex& index = network->getLocationIndex();
+    while (v != tree->root) {
+        result.push_back(index.toId(v));
+        v = network->edgeSource(tree->parentEdge[v]);
+    }
+    result.push_back(index.toId(tree->root));
+    std::reverse(result.begin(), result.end());
+    return result;
+}
@@ -1,7 +1,29 @@
 #include "SmartCitySystem.hpp"
+#include "Benchmarks.hpp"
+#include <cstdlib>
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // Benchmark mode: SmartCity --bench [name] [size]
+        if (argc > 1 && std::string(argv[1]) == "--bench") {
+            std::string name = (argc > 2) ? argv[2] : "all";
+            int size = (argc > 3) ? std::atoi(argv[3]) : 0;
+            if (!Benchmarks::run(name, size)) {
+                std::cerr << "Unknown benchmark: " << name << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+        
+        // Streaming mode: SmartCity --stream <file or named pipe> [seconds]
+        if (argc > 2 && std::string(argv[1]) == "--stream") {
+            int seconds = (argc > 3) ? std::atoi(argv[3]) : 10;
+            SmartCityDeliverySystem system;
+            system.initialize();
+            system.streamTrafficUpdates(argv[2], seconds > 0 ? seconds : 10);
+            return 0;
+        }
+        
         SmartCityDeliverySystem system;
         system.runFullSystem();
     } catch (const std::exception& e) {
@@ -10,4 +32,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -1,162 +1,1138 @@
 #include "Network.hpp"
+#include "ContractionHierarchy.hpp"
+#include "ThreadPool.hpp"
+#include "CitySnapshot.hpp"
 #include <limits>
+#include <cmath>
 #include <algorithm>
+#include <functional>
+
+RoadNetwork::RoadNetwork()
+    : hasCoordinates(false), heuristicScale(0.0), metricScale{0.0, 0.0, 0.0}, longestEdgeKm(0.0), version(0), finalized(false), layoutVersion(0),
+      profiledEdges(0), profileHeuristicScale(0.0), stagingPending(false),
+      stagedWeightsStale(false) {}
 
 // ================ Get Location ID by Name Function ================ //
-int RoadNetwork::getLocationIdByName(const std::string& name, const std::vector<Location>& locations) {
+int RoadNetwork::getLocationIdByName(const std::string& name, const std::vector<Location>& locations) const {
+    // Interned names first; the scan only serves locations the index lacks
+    int id = index.idOfName(name);
+    if (id != -1) return id;
     for (const auto& loc : locations) {
         if (loc.name == name) {
             return loc.id;
         }
     }
-    return -1; 
+    return -1;
+}
+
+// ================ Location Index ================= //
+void RoadNetwork::setLocationIndex(const LocationIndex& locationIndex) {
+    restoreStaging();
+    // Re-key anything already staged under the new mapping
+    std::vector<std::vector<std::pair<int, double>>> staged;
+    std::vector<std::vector<EdgeMetrics>> stagedMetrics;
+    std::vector<std::vector<int>> stagedRoads;
+    staged.swap(adjList);
+    stagedMetrics.swap(adjMetrics);
+    stagedRoads.swap(adjRoads);
+    LocationIndex previous = index;
+    index = locationIndex;
+    bool wasFinalized = finalized;
+    finalized = false;
+
+    for (size_t u = 0; u < staged.size(); u++) {
+        int src = previous.toId(static_cast<int>(u));
+        for (size_t i = 0; i < staged[u].size(); i++) {
+            addEdge(src, previous.toId(staged[u][i].first), staged[u][i].second, stagedMetrics[u][i],
+                    stagedRoads[u][i]);
+        }
+    }
+    if (wasFinalized) finalize();
+}
+
+const LocationIndex& RoadNetwork::getLocationIndex() const {
+    return index;
+}
+
+// ================ Node Coordinates ================= //
+void RoadNetwork::setNodes(const std::vector<Location>& locations) {
+    std::vector<bool> seen(index.size(), false);
+    nodes.resize(index.size());
+    for (const auto& loc : locations) {
+        int u = index.add(loc.id);
+        if (u >= static_cast<int>(nodes.size())) {
+            nodes.resize(u + 1);
+            seen.resize(u + 1, false);
+        }
+        nodes[u] = loc;
+        seen[u] = true;
+    }
+    hasCoordinates = std::find(seen.begin(), seen.end(), false) == seen.end();
+    if (finalized) calibrateHeuristic();
+}
+
+double RoadNetwork::getHeuristicScale() const {
+    return heuristicScale;
+}
+
+// The bound is admissible and consistent as long as every edge satisfies
+// weight >= scale * greatCircle(u, v); by the triangle inequality on the
+// sphere no path can then be cheaper than scale * greatCircle(s, t). The
+// scale is the tightest such factor over the mixed distance/time weights.
+void RoadNetwork::calibrateHeuristic() {
+    heuristicScale = 0.0;
+    profileHeuristicScale = 0.0;
+    metricScale = EdgeMetrics{0.0, 0.0, 0.0};
+    longestEdgeKm = 0.0;
+    if (!hasCoordinates || nodes.size() < static_cast<size_t>(nodeCount())) return;
+
+    // Profiles interpolate between breakpoints, so their minimum is a breakpoint
+    const double NONE = std::numeric_limits<double>::max();
+    double scale = NONE;
+    double profileScale = NONE;
+    EdgeMetrics metrics{NONE, NONE, NONE};
+    for (int u = 0; u < nodeCount(); u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            const Location& a = nodes[u];
+            const Location& b = nodes[targets[e]];
+            double km = FileUtils::greatCircleDistance(a.latitude, a.longitude, b.latitude, b.longitude);
+            if (km <= 0.0) continue;
+            longestEdgeKm = std::max(longestEdgeKm, km);
+            scale = std::min(scale, weights[e] / km);
+            profileScale = std::min(profileScale, weights[e] / km);
+            for (int p = profileOffsets[e]; p < profileOffsets[e + 1]; p++) {
+                profileScale = std::min(profileScale, profileWeights[p] / km);
+            }
+            metrics.distance = std::min(metrics.distance, distances[e] / km);
+            metrics.congestion = std::min(metrics.congestion, congestions[e] / km);
+            metrics.time = std::min(metrics.time, times[e] / km);
+        }
+    }
+    // Shave off a hair so rounding can never make the bound overestimate
+    auto shave = [NONE](double value) {
+        return (value != NONE && value > 0.0) ? value * (1.0 - 1e-9) : 0.0;
+    };
+    heuristicScale = shave(scale);
+    profileHeuristicScale = shave(profileScale);
+    metricScale = EdgeMetrics{shave(metrics.distance), shave(metrics.congestion), shave(metrics.time)};
+}
+
+// Per-metric bounds combine linearly: for non-negative factors the minimum of
+// a sum is at least the sum of the minimums, so no recalibration is needed
+double RoadNetwork::profileScale(const WeightProfile& profile) const {
+    if (profile.live) return heuristicScale;
+    return profile.distanceFactor * metricScale.distance +
+           profile.congestionFactor * metricScale.congestion +
+           profile.timeFactor * metricScale.time;
 }
+
+double RoadNetwork::lowerBound(int u, int target, double scale) const {
+    if (scale == 0.0) return 0.0;
+    const Location& a = nodes[u];
+    const Location& b = nodes[target];
+    return scale * FileUtils::greatCircleDistance(a.latitude, a.longitude, b.latitude, b.longitude);
+}
+
 // ================ Basic Graph Operations ================= //
 
+// Structural changes go to the staging lists and unfreeze the graph, so a
+// batch of edits costs one finalize() instead of one per edit; traversals
+// refuse the stale layout until then.
 void RoadNetwork::addEdge(int src, int dest, double weight) {
-    adjList[src].emplace_back(dest, weight);
+    addEdge(src, dest, weight, EdgeMetrics{weight, weight, weight});
+}
+void RoadNetwork::addEdge(int src, int dest, double weight, const EdgeMetrics& metrics, int roadId) {
+    restoreStaging();
+    int u = index.add(src);
+    int v = index.add(dest);
+    if (adjList.size() < static_cast<size_t>(index.size())) {
+        adjList.resize(index.size());
+        adjMetrics.resize(index.size());
+        adjRoads.resize(index.size());
+    }
+    adjList[u].emplace_back(v, weight);
+    adjMetrics[u].push_back(metrics);
+    adjRoads[u].push_back(std::max(0, roadId));
+    version++;
+    finalized = false;
 }
 void RoadNetwork::removeEdge(int nodeId) {
-    adjList.erase(nodeId);
+    restoreStaging();
+    int u = index.toIndex(nodeId);
+    if (u == -1 || u >= static_cast<int>(adjList.size())) return;
+    adjList[u].clear();
+    adjMetrics[u].clear();
+    adjRoads[u].clear();
+    version++;
+    finalized = false;
 }
 void RoadNetwork::updateEdgeWeight(int src, int dest, double newWeight) {
-    for (auto& neighbor : adjList[src]) {
-        if (neighbor.first == dest) {
-            neighbor.second = newWeight;
+    int u = index.toIndex(src);
+    int v = index.toIndex(dest);
+    if (u == -1 || v == -1) return;
+    // A restored graph keeps its weights in the frozen arrays until staging is rebuilt
+    if (!stagingPending) {
+        if (u >= static_cast<int>(adjList.size())) return;
+        for (auto& neighbor : adjList[u]) {
+            if (neighbor.first == v) {
+                neighbor.second = newWeight;
+                break;
+            }
+        }
+    }
+    version++;
+
+    // Patch the frozen weight in place, no rebuild needed
+    if (!finalized || u >= nodeCount()) return;
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+        if (targets[e] == v) {
+            applyEdgeWeight(u, e, newWeight);
             break;
         }
     }
 }
 
+void RoadNetwork::applyEdgeWeight(int u, int e, double newWeight) {
+    double previous = weights[e];
+    weights[e] = newWeight;
+    if (!edgeChanged[e]) {
+        edgeChanged[e] = true;
+        changedEdges.push_back(e);
+    }
+
+    // A cheaper edge may tighten the admissible heuristic scale; a dearer
+    // one, or one above the scale on the longest edge, never breaks it
+    if (heuristicScale > 0.0 && newWeight < previous && newWeight < heuristicScale * longestEdgeKm) {
+        if (u == -1) u = edgeSource(e);
+        int v = targets[e];
+        double km = FileUtils::greatCircleDistance(nodes[u].latitude, nodes[u].longitude,
+                                                   nodes[v].latitude, nodes[v].longitude);
+        if (km > 0.0 && newWeight / km < heuristicScale) {
+            heuristicScale = std::max(0.0, newWeight / km * (1.0 - 1e-9));
+        }
+        if (km > 0.0 && newWeight / km < profileHeuristicScale) {
+            profileHeuristicScale = std::max(0.0, newWeight / km * (1.0 - 1e-9));
+        }
+    }
+}
+
+// ================ Road-ID Updates ================= //
+// Searches assume positive weights: zero, negative or non-finite ones are refused
+bool RoadNetwork::updateRoadWeight(int roadId, double newWeight) {
+    int e = roadSlot(roadId);
+    if (e == -1 || !(newWeight > 0.0 && std::isfinite(newWeight))) return false;
+    applyEdgeWeight(-1, e, newWeight);
+    stagedWeightsStale = true;
+    version++;
+    return true;
+}
+
+int RoadNetwork::updateRoadWeights(const RoadWeightUpdate* updates, size_t count) {
+    int applied = 0;
+    for (size_t i = 0; i < count; i++) {
+        int e = roadSlot(updates[i].roadId);
+        if (e == -1 || !(updates[i].weight > 0.0 && std::isfinite(updates[i].weight))) continue;
+        applyEdgeWeight(-1, e, updates[i].weight);
+        applied++;
+    }
+    // One version bump per batch: caches see the burst as a single change
+    if (applied > 0) {
+        stagedWeightsStale = true;
+        version++;
+    }
+    return applied;
+}
+
+int RoadNetwork::updateRoadWeights(const std::vector<RoadWeightUpdate>& updates) {
+    return updateRoadWeights(updates.data(), updates.size());
+}
+
+int RoadNetwork::roadSlot(int roadId) const {
+    if (!finalized || roadId <= 0 || roadId >= static_cast<int>(roadSlots.size())) return -1;
+    return roadSlots[roadId];
+}
+
+int RoadNetwork::roadLimit() const {
+    return static_cast<int>(roadSlots.size());
+}
+
+// ================ Travel-Time Profiles ================= //
+void RoadNetwork::setTravelTimeProfile(int roadId, std::vector<ProfilePoint> points) {
+    restoreStaging();
+    if (roadId <= 0) return;
+    if (points.empty()) {
+        stagedProfiles.erase(roadId);
+    } else {
+        // Fold into one day, sort, and keep the last value given for a time
+        for (auto& point : points) {
+            point.secondOfDay = ((point.secondOfDay % SECONDS_PER_DAY) + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+        }
+        std::stable_sort(points.begin(), points.end(), [](const ProfilePoint& a, const ProfilePoint& b) {
+            return a.secondOfDay < b.secondOfDay;
+        });
+        std::vector<ProfilePoint> merged;
+        for (const auto& point : points) {
+            if (!merged.empty() && merged.back().secondOfDay == point.secondOfDay) {
+                merged.back() = point;
+            } else {
+                merged.push_back(point);
+            }
+        }
+
+        // FIFO: the weight may fall by at most 1/60 minute per second.
+        // Walking once round the day from the highest breakpoint and raising
+        // each one to its predecessor's bound settles every segment, the one
+        // across midnight included (it ends on the maximum).
+        size_t count = merged.size();
+        size_t top = std::max_element(merged.begin(), merged.end(), [](const ProfilePoint& a, const ProfilePoint& b) {
+            return a.weight < b.weight;
+        }) - merged.begin();
+        for (size_t step = 1; step < count; step++) {
+            const ProfilePoint& prev = merged[(top + step - 1) % count];
+            ProfilePoint& point = merged[(top + step) % count];
+            int gap = point.secondOfDay - prev.secondOfDay;
+            if (gap <= 0) gap += SECONDS_PER_DAY;
+            point.weight = std::max(point.weight, prev.weight - gap / 60.0);
+        }
+        stagedProfiles[roadId] = std::move(merged);
+    }
+
+    if (finalized) {
+        layoutProfiles();
+        calibrateHeuristic();
+    }
+}
+
+int RoadNetwork::profileCount() const {
+    return profiledEdges;
+}
+
+void RoadNetwork::layoutProfiles() {
+    int m = edgeCount();
+    std::vector<const std::vector<ProfilePoint>*> byEdge(m, nullptr);
+    profiledEdges = 0;
+    for (const auto& [roadId, points] : stagedProfiles) {
+        // Roads not in the graph (yet) stay staged
+        if (roadId >= static_cast<int>(roadSlots.size()) || roadSlots[roadId] == -1) continue;
+        byEdge[roadSlots[roadId]] = &points;
+        profiledEdges++;
+    }
+
+    profileOffsets.assign(m + 1, 0);
+    for (int e = 0; e < m; e++) {
+        profileOffsets[e + 1] = profileOffsets[e] + (byEdge[e] ? static_cast<int>(byEdge[e]->size()) : 0);
+    }
+    profileTimes.resize(profileOffsets[m]);
+    profileWeights.resize(profileOffsets[m]);
+    for (int e = 0; e < m; e++) {
+        if (!byEdge[e]) continue;
+        int p = profileOffsets[e];
+        for (const auto& point : *byEdge[e]) {
+            profileTimes[p] = point.secondOfDay;
+            profileWeights[p] = point.weight;
+            p++;
+        }
+    }
+}
+
+double RoadNetwork::edgeWeightAt(int e, double secondOfDay) const {
+    int begin = profileOffsets[e];
+    int count = profileOffsets[e + 1] - begin;
+    if (count == 0) return weights[e];
+
+    double t = std::fmod(secondOfDay, static_cast<double>(SECONDS_PER_DAY));
+    if (t < 0.0) t += SECONDS_PER_DAY;
+
+    // Breakpoints either side of t, wrapping around midnight
+    const int* times = profileTimes.data() + begin;
+    const double* values = profileWeights.data() + begin;
+    int next = static_cast<int>(std::upper_bound(times, times + count, t) - times);
+    int prev = (next == 0) ? count - 1 : next - 1;
+    double t0 = times[prev] - (next == 0 ? SECONDS_PER_DAY : 0);
+    double t1 = (next == count) ? times[0] + SECONDS_PER_DAY : times[next];
+    if (next == count) next = 0;
+
+    return values[prev] + (values[next] - values[prev]) * (t - t0) / (t1 - t0);
+}
+
+// ================ CSR Finalization ================= //
+void RoadNetwork::finalize() {
+    restoreStaging();
+    int n = index.size();
+    adjList.resize(n);
+    adjMetrics.resize(n);
+    adjRoads.resize(n);
+
+    // Prefix sums of out-degrees give each node's edge range
+    offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        offsets[u + 1] = offsets[u] + static_cast<int>(adjList[u].size());
+    }
+
+    // Fill targets/weights/metrics, keeping each node's insertion order
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    distances.resize(offsets[n]);
+    congestions.resize(offsets[n]);
+    times.resize(offsets[n]);
+    for (int u = 0; u < n; u++) {
+        int e = offsets[u];
+        for (size_t i = 0; i < adjList[u].size(); i++, e++) {
+            targets[e] = adjList[u][i].first;
+            weights[e] = adjList[u][i].second;
+            distances[e] = adjMetrics[u][i].distance;
+            congestions[e] = adjMetrics[u][i].congestion;
+            times[e] = adjMetrics[u][i].time;
+        }
+    }
+
+    // Road IDs follow their edges into the new slots (a reused ID keeps the last edge)
+    int roadCount = 1;
+    for (int u = 0; u < n; u++) {
+        for (int roadId : adjRoads[u]) roadCount = std::max(roadCount, roadId + 1);
+    }
+    roadSlots.assign(roadCount, -1);
+    for (int u = 0; u < n; u++) {
+        for (size_t i = 0; i < adjRoads[u].size(); i++) {
+            if (adjRoads[u][i] > 0) roadSlots[adjRoads[u][i]] = offsets[u] + static_cast<int>(i);
+        }
+    }
+
+    // Reverse layout: bucket every edge by its head
+    reverseOffsets.assign(n + 1, 0);
+    for (int e = 0; e < offsets[n]; e++) {
+        reverseOffsets[targets[e] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        reverseOffsets[v + 1] += reverseOffsets[v];
+    }
+    reverseSources.resize(offsets[n]);
+    reverseEdges.resize(offsets[n]);
+    std::vector<int> fill(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (int u = 0; u < n; u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int slot = fill[targets[e]]++;
+            reverseSources[slot] = u;
+            reverseEdges[slot] = e;
+        }
+    }
+
+    // Slots were renumbered: pending change records no longer apply
+    changedEdges.clear();
+    edgeChanged.assign(offsets[n], false);
+    layoutVersion++;
+
+    finalized = true;
+    layoutProfiles();
+    calibrateHeuristic();
+}
+
+bool RoadNetwork::isFinalized() const {
+    return finalized;
+}
+
+int RoadNetwork::nodeCount() const {
+    return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1;
+}
+
+int RoadNetwork::edgeCount() const {
+    return static_cast<int>(targets.size());
+}
+
+// FNV-1a over the CSR arrays; any topology or weight change alters it
+uint64_t RoadNetwork::fingerprint() const {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(offsets.data(), offsets.size() * sizeof(int));
+    mix(targets.data(), targets.size() * sizeof(int));
+    mix(weights.data(), weights.size() * sizeof(double));
+    return hash;
+}
+
+uint64_t RoadNetwork::getVersion() const {
+    return version;
+}
+
+// Tail of an edge slot: the node whose CSR range contains it
+int RoadNetwork::edgeSource(int e) const {
+    return static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), e) - offsets.begin()) - 1;
+}
+
+std::vector<int> RoadNetwork::takeChangedEdges() {
+    std::vector<int> changed;
+    changed.swap(changedEdges);
+    for (int e : changed) edgeChanged[e] = false;
+    return changed;
+}
+
+uint64_t RoadNetwork::getLayoutVersion() const {
+    return layoutVersion;
+}
+
+// ================ Snapshot ================= //
+namespace {
+
+struct GraphScalars {
+    double heuristicScale;
+    double profileHeuristicScale;
+    double distanceScale, congestionScale, timeScale;
+    double longestEdgeKm;
+    int64_t profiledEdges;
+};
+
+}  // namespace
+
+void RoadNetwork::writeSnapshot(SnapshotWriter& writer) const {
+    writer.addArray(SnapshotSection::GraphOffsets, offsets);
+    writer.addArray(SnapshotSection::GraphTargets, targets);
+    writer.addArray(SnapshotSection::GraphWeights, weights);
+    writer.addArray(SnapshotSection::GraphDistances, distances);
+    writer.addArray(SnapshotSection::GraphCongestions, congestions);
+    writer.addArray(SnapshotSection::GraphTimes, times);
+    writer.addArray(SnapshotSection::GraphReverseOffsets, reverseOffsets);
+    writer.addArray(SnapshotSection::GraphReverseSources, reverseSources);
+    writer.addArray(SnapshotSection::GraphReverseEdges, reverseEdges);
+    writer.addArray(SnapshotSection::GraphRoadSlots, roadSlots);
+    writer.addArray(SnapshotSection::ProfileOffsets, profileOffsets);
+    writer.addArray(SnapshotSection::ProfileTimes, profileTimes);
+    writer.addArray(SnapshotSection::ProfileWeights, profileWeights);
+    std::vector<GraphScalars> scalars{{heuristicScale, profileHeuristicScale, metricScale.distance,
+                                       metricScale.congestion, metricScale.time, longestEdgeKm,
+                                       profiledEdges}};
+    writer.addArray(SnapshotSection::GraphScalars, scalars);
+}
+
+bool RoadNetwork::readSnapshot(const SnapshotReader& reader) {
+    std::vector<int> loadedOffsets, loadedTargets, loadedReverseOffsets, loadedReverseSources,
+        loadedReverseEdges, loadedRoadSlots, loadedProfileOffsets, loadedProfileTimes;
+    std::vector<double> loadedWeights, loadedDistances, loadedCongestions, loadedTimes, loadedProfileWeights;
+    std::vector<GraphScalars> scalars;
+    if (!reader.readArray(SnapshotSection::GraphOffsets, loadedOffsets) ||
+        !reader.readArray(SnapshotSection::GraphTargets, loadedTargets) ||
+        !reader.readArray(SnapshotSection::GraphWeights, loadedWeights) ||
+        !reader.readArray(SnapshotSection::GraphDistances, loadedDistances) ||
+        !reader.readArray(SnapshotSection::GraphCongestions, loadedCongestions) ||
+        !reader.readArray(SnapshotSection::GraphTimes, loadedTimes) ||
+        !reader.readArray(SnapshotSection::GraphReverseOffsets, loadedReverseOffsets) ||
+        !reader.readArray(SnapshotSection::GraphReverseSources, loadedReverseSources) ||
+        !reader.readArray(SnapshotSection::GraphReverseEdges, loadedReverseEdges) ||
+        !reader.readArray(SnapshotSection::GraphRoadSlots, loadedRoadSlots) || loadedRoadSlots.empty() ||
+        !reader.readArray(SnapshotSection::ProfileOffsets, loadedProfileOffsets) ||
+        !reader.readArray(SnapshotSection::ProfileTimes, loadedProfileTimes) ||
+        !reader.readArray(SnapshotSection::ProfileWeights, loadedProfileWeights) ||
+        !reader.readArray(SnapshotSection::GraphScalars, scalars) || scalars.size() != 1) {
+        return false;
+    }
+
+    // Shapes must agree with each other and with the location index, and
+    // every stored index must stay in range
+    size_t n = index.size();
+    if (loadedOffsets.size() != n + 1 || loadedReverseOffsets.size() != n + 1) return false;
+    size_t m = loadedTargets.size();
+    if (loadedWeights.size() != m || loadedDistances.size() != m || loadedCongestions.size() != m ||
+        loadedTimes.size() != m || loadedReverseSources.size() != m || loadedReverseEdges.size() != m ||
+        loadedProfileOffsets.size() != m + 1 || loadedProfileTimes.size() != loadedProfileWeights.size()) {
+        return false;
+    }
+    auto monotone = [](const std::vector<int>& prefix, size_t total) {
+        if (prefix.front() != 0 || static_cast<size_t>(prefix.back()) != total) return false;
+        return std::is_sorted(prefix.begin(), prefix.end());
+    };
+    auto inRange = [](const std::vector<int>& values, size_t bound) {
+        return std::all_of(values.begin(), values.end(),
+                           [bound](int value) { return value >= 0 && static_cast<size_t>(value) < bound; });
+    };
+    if (!monotone(loadedOffsets, m) || !monotone(loadedReverseOffsets, m) ||
+        !monotone(loadedProfileOffsets, loadedProfileTimes.size()) ||
+        !inRange(loadedTargets, n) || !inRange(loadedReverseSources, n) || !inRange(loadedReverseEdges, m)) {
+        return false;
+    }
+    if (!std::all_of(loadedRoadSlots.begin(), loadedRoadSlots.end(),
+                     [m](int slot) { return slot >= -1 && slot < static_cast<int>(m); })) {
+        return false;
+    }
+
+    // Profiles must hold what setTravelTimeProfile guarantees: strictly
+    // increasing times within one day (edgeWeightAt divides by the gaps)
+    // and FIFO slopes, midnight segment included
+    for (size_t e = 0; e < m; e++) {
+        int begin = loadedProfileOffsets[e], end = loadedProfileOffsets[e + 1];
+        for (int p = begin; p < end; p++) {
+            int time = loadedProfileTimes[p];
+            if (time < 0 || time >= SECONDS_PER_DAY || !std::isfinite(loadedProfileWeights[p])) return false;
+            if (p > begin && time <= loadedProfileTimes[p - 1]) return false;
+            int prev = (p == begin) ? end - 1 : p - 1;
+            int gap = time - loadedProfileTimes[prev];
+            if (gap <= 0) gap += SECONDS_PER_DAY;
+            if (loadedProfileWeights[p] < loadedProfileWeights[prev] - gap / 60.0) return false;
+        }
+    }
+
+    offsets.swap(loadedOffsets);
+    targets.swap(loadedTargets);
+    weights.swap(loadedWeights);
+    distances.swap(loadedDistances);
+    congestions.swap(loadedCongestions);
+    times.swap(loadedTimes);
+    reverseOffsets.swap(loadedReverseOffsets);
+    reverseSources.swap(loadedReverseSources);
+    reverseEdges.swap(loadedReverseEdges);
+    roadSlots.swap(loadedRoadSlots);
+    profileOffsets.swap(loadedProfileOffsets);
+    profileTimes.swap(loadedProfileTimes);
+    profileWeights.swap(loadedProfileWeights);
+    heuristicScale = scalars[0].heuristicScale;
+    profileHeuristicScale = scalars[0].profileHeuristicScale;
+    metricScale = EdgeMetrics{scalars[0].distanceScale, scalars[0].congestionScale, scalars[0].timeScale};
+    longestEdgeKm = scalars[0].longestEdgeKm;
+    profiledEdges = static_cast<int>(scalars[0].profiledEdges);
+
+    // Same bookkeeping as finalize(), minus the staging area
+    adjList.clear();
+    adjMetrics.clear();
+    adjRoads.clear();
+    stagedProfiles.clear();
+    stagingPending = true;
+    stagedWeightsStale = false;
+    changedEdges.clear();
+    edgeChanged.assign(m, false);
+    layoutVersion++;
+    version++;
+    finalized = true;
+    return true;
+}
+
+// Inverse of finalize(): per-node lists in slot order, profiles keyed by road
+void RoadNetwork::restoreStaging() {
+    if (stagedWeightsStale && !stagingPending) {
+        // Staged lists mirror the frozen slots; only the weights moved on
+        for (int u = 0; u < nodeCount(); u++) {
+            for (size_t i = 0; i < adjList[u].size(); i++) {
+                adjList[u][i].second = weights[offsets[u] + i];
+            }
+        }
+    }
+    stagedWeightsStale = false;
+    if (!stagingPending) return;
+    stagingPending = false;
+    int n = nodeCount();
+    std::vector<int> edgeRoads(edgeCount(), 0);
+    for (size_t roadId = 1; roadId < roadSlots.size(); roadId++) {
+        if (roadSlots[roadId] != -1) edgeRoads[roadSlots[roadId]] = static_cast<int>(roadId);
+    }
+    adjList.assign(n, {});
+    adjMetrics.assign(n, {});
+    adjRoads.assign(n, {});
+    for (int u = 0; u < n; u++) {
+        adjList[u].reserve(offsets[u + 1] - offsets[u]);
+        adjMetrics[u].reserve(offsets[u + 1] - offsets[u]);
+        adjRoads[u].reserve(offsets[u + 1] - offsets[u]);
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            adjList[u].emplace_back(targets[e], weights[e]);
+            adjMetrics[u].push_back(EdgeMetrics{distances[e], congestions[e], times[e]});
+            adjRoads[u].push_back(edgeRoads[e]);
+            if (profileOffsets[e] == profileOffsets[e + 1] || edgeRoads[e] == 0) continue;
+            std::vector<ProfilePoint>& points = stagedProfiles[edgeRoads[e]];
+            for (int p = profileOffsets[e]; p < profileOffsets[e + 1]; p++) {
+                points.push_back({profileTimes[p], profileWeights[p]});
+            }
+        }
+    }
+}
+
+// ================ Search Workspace ================= //
+void SearchWorkspace::prepare(int n) {
+    if (static_cast<int>(distF.size()) >= n) return;
+    const double INF = std::numeric_limits<double>::max();
+    distF.assign(n, INF);
+    distB.assign(n, INF);
+    parentF.assign(n, -1);
+    parentB.assign(n, -1);
+    settledF.assign(n, false);
+    settledB.assign(n, false);
+    touched.clear();
+}
+
+void SearchWorkspace::reset() {
+    const double INF = std::numeric_limits<double>::max();
+    for (int u : touched) {
+        distF[u] = distB[u] = INF;
+        parentF[u] = parentB[u] = -1;
+        settledF[u] = settledB[u] = false;
+    }
+    touched.clear();
+}
+
 // ================ Dijkstra's Algorithm ================= //
-std::vector<int> RoadNetwork::shortestPath(int source, int destination) {
-    // Initialize distances and parent tracking
-    std::unordered_map<int, double> distance;
-    std::unordered_map<int, int> parent;
-    std::unordered_set<int> visited;
-    
-    // Priority queue: (distance, node)
+std::vector<int> RoadNetwork::shortestPath(int source, int destination, SearchMode mode,
+                                          SearchStats* stats, const WeightProfile& profile) const {
+    // Convert at the API boundary: IDs in, IDs out
+    std::vector<int> path = shortestPathIndices(index.toIndex(source), index.toIndex(destination),
+                                                mode, stats, profile);
+    for (auto& node : path) {
+        node = index.toId(node);
+    }
+    return path;
+}
+
+std::vector<int> RoadNetwork::shortestPathIndices(int src, int dest, SearchMode mode,
+                                                  SearchStats* stats, const WeightProfile& profile) const {
+    SearchWorkspace workspace;
+    return search(src, dest, mode, profile, workspace, stats);
+}
+
+double RoadNetwork::pathCost(const std::vector<int>& path, const WeightProfile& profile) const {
+    const double INF = std::numeric_limits<double>::max();
+    if (path.empty()) return INF;
+    double total = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        int u = index.toIndex(path[i]);
+        int v = index.toIndex(path[i + 1]);
+        if (!finalized || u < 0 || v < 0 || u >= nodeCount()) return INF;
+        // Cheapest parallel road, as a search would take it
+        double best = INF;
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (targets[e] == v) best = std::min(best, edgeCost(e, profile));
+        }
+        if (best == INF) return INF;
+        total += best;
+    }
+    return total;
+}
+
+std::vector<int> RoadNetwork::search(int src, int dest, SearchMode mode, const WeightProfile& profile,
+                                     SearchWorkspace& workspace, SearchStats* stats) const {
+    std::vector<int> path;
+    int n = nodeCount();
+    if (!finalized || src < 0 || dest < 0 || src >= n || dest >= n) {
+        return path;
+    }
+    workspace.prepare(n);
+    if (mode == SearchMode::Bidirectional) {
+        path = bidirectionalSearch(src, dest, profile, workspace, stats);
+        workspace.reset();
+        return path;
+    }
+
+    // Distances and parent tracking live in the workspace
+    std::vector<double>& distance = workspace.distF;
+    std::vector<int>& parent = workspace.parentF;
+    std::vector<bool>& visited = workspace.settledF;
+    std::vector<int>& touched = workspace.touched;
+    int settled = 0;
+
+    // A* orders the queue by distance + lower bound; Dijkstra uses a zero bound
+    double scale = (mode == SearchMode::AStar) ? profileScale(profile) : 0.0;
+    auto estimate = [&](int u) {
+        return lowerBound(u, dest, scale);
+    };
+
+    // Priority queue: (distance + estimate, node)
     auto cmp = [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
         return a.first > b.first;  // Min-heap
     };
-    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, 
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>,
                        decltype(cmp)> pq(cmp);
-    
-    // Initialize all distances to infinity
-    for (const auto& node : adjList) {
-        distance[node.first] = std::numeric_limits<double>::max();
-        parent[node.first] = -1;
-    }
-    
+
     // Set source distance to 0
-    distance[source] = 0.0;
-    pq.push({0.0, source});
-    
+    distance[src] = 0.0;
+    touched.push_back(src);
+    pq.push({estimate(src), src});
+
     // Dijkstra's main loop
     while (!pq.empty()) {
-        auto [curr_dist, curr_node] = pq.top();
+        int curr_node = pq.top().second;
         pq.pop();
-        
-        // Skip if already visited
-        if (visited.count(curr_node)) {
+
+        // Skip if already visited (stale queue entry)
+        if (visited[curr_node]) {
             continue;
         }
-        
-        visited.insert(curr_node);
-        
+
+        visited[curr_node] = true;
+        settled++;
+
         // If we reached destination, we can stop early
-        if (curr_node == destination) {
+        if (curr_node == dest) {
             break;
         }
-        
-        // Skip if this distance is outdated
-        if (curr_dist > distance[curr_node]) {
-            continue;
-        }
-        
-        // Relax all neighbors
-        if (adjList.count(curr_node)) {
-            for (const auto& [neighbor, weight] : adjList[curr_node]) {
-                double newDist = distance[curr_node] + weight;
-                
-                // Found shorter path
-                if (newDist < distance[neighbor]) {
-                    distance[neighbor] = newDist;
-                    parent[neighbor] = curr_node;
-                    pq.push({newDist, neighbor});
-                }
+
+        // Relax all neighbors over the contiguous edge range
+        for (int e = offsets[curr_node]; e < offsets[curr_node + 1]; e++) {
+            int neighbor = targets[e];
+            double newDist = distance[curr_node] + edgeCost(e, profile);
+
+            // Found shorter path
+            if (newDist < distance[neighbor]) {
+                if (distance[neighbor] == std::numeric_limits<double>::max()) touched.push_back(neighbor);
+                distance[neighbor] = newDist;
+                parent[neighbor] = curr_node;
+                pq.push({newDist + estimate(neighbor), neighbor});
             }
         }
     }
-    
+
+    if (stats) stats->settledNodes = settled;
+
     // Reconstruct path from destination to source
+    if (distance[dest] != std::numeric_limits<double>::max()) {
+        int curr = dest;
+        while (curr != -1) {
+            path.push_back(curr);
+            curr = parent[curr];
+        }
+
+        // Reverse to get path from source to destination
+        std::reverse(path.begin(), path.end());
+    }
+
+    workspace.reset();
+    return path;
+}
+
+// ================ Time-Dependent Routing ================= //
+std::vector<int> RoadNetwork::shortestPathAt(int source, int destination, double departureSeconds,
+                                            SearchMode mode, SearchStats* stats,
+                                            double* arrivalSeconds) const {
+    if (arrivalSeconds) *arrivalSeconds = std::numeric_limits<double>::max();
+    int src = index.toIndex(source);
+    int dest = index.toIndex(destination);
+    int n = nodeCount();
+    if (!finalized || src < 0 || dest < 0 || src >= n || dest >= n) {
+        return std::vector<int>();
+    }
+
+    SearchWorkspace workspace;
+    workspace.prepare(n);
+    std::vector<int> path = timeDependentSearch(src, dest, departureSeconds, mode == SearchMode::AStar,
+                                                workspace, stats, arrivalSeconds);
+    for (auto& node : path) {
+        node = index.toId(node);
+    }
+    return path;
+}
+
+std::vector<int> RoadNetwork::timeDependentSearch(int src, int dest, double departureSeconds,
+                                                  bool goalDirected, SearchWorkspace& workspace,
+                                                  SearchStats* stats, double* arrivalSeconds) const {
+    const double INF = std::numeric_limits<double>::max();
     std::vector<int> path;
-    if (distance[destination] == std::numeric_limits<double>::max()) {
-        // No path exists
-        return path;
+
+    // Labels are arrival times in seconds
+    std::vector<double>& arrival = workspace.distF;
+    std::vector<int>& parent = workspace.parentF;
+    std::vector<bool>& visited = workspace.settledF;
+    std::vector<int>& touched = workspace.touched;
+    int settled = 0;
+
+    // Seconds of travel still needed at the best possible profile values
+    double scale = goalDirected ? 60.0 * profileHeuristicScale : 0.0;
+    auto estimate = [&](int u) {
+        return lowerBound(u, dest, scale);
+    };
+
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+    arrival[src] = departureSeconds;
+    touched.push_back(src);
+    pq.push({departureSeconds + estimate(src), src});
+
+    while (!pq.empty()) {
+        int u = pq.top().second;
+        pq.pop();
+        if (visited[u]) continue;
+        visited[u] = true;
+        settled++;
+        if (u == dest) break;
+
+        // Each road is priced at the moment it is entered
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = targets[e];
+            double newArrival = arrival[u] + 60.0 * edgeWeightAt(e, arrival[u]);
+            if (newArrival < arrival[v]) {
+                if (arrival[v] == INF) touched.push_back(v);
+                arrival[v] = newArrival;
+                parent[v] = u;
+                pq.push({newArrival + estimate(v), v});
+            }
+        }
     }
-    
-    int curr = destination;
-    while (curr != -1) {
-        path.push_back(curr);
-        curr = parent[curr];
+
+    if (stats) stats->settledNodes = settled;
+    if (arrival[dest] != INF) {
+        if (arrivalSeconds) *arrivalSeconds = arrival[dest];
+        for (int v = dest; v != -1; v = parent[v]) path.push_back(v);
+        std::reverse(path.begin(), path.end());
+    }
+
+    workspace.reset();
+    return path;
+}
+
+// ================ Batch Routing ================= //
+std::vector<std::vector<int>> RoadNetwork::shortestPaths(const std::vector<std::pair<int, int>>& queries,
+                                                         ThreadPool& pool, SearchMode mode,
+                                                         const ContractionHierarchy* hierarchy,
+                                                         const WeightProfile& profile) const {
+    std::vector<std::vector<int>> paths(queries.size());
+    bool useHierarchy = profile.live && hierarchy && hierarchy->isValidFor(*this);
+
+    // Workers never share scratch state; each result slot has a single writer
+    std::vector<SearchWorkspace> workspaces(pool.size());
+    pool.parallelFor(queries.size(), [&](int slot, size_t i) {
+        int src = index.toIndex(queries[i].first);
+        int dest = index.toIndex(queries[i].second);
+        std::vector<int> path = useHierarchy
+            ? hierarchy->shortestPathIndices(src, dest)
+            : search(src, dest, mode, profile, workspaces[slot], nullptr);
+        for (auto& node : path) {
+            node = index.toId(node);
+        }
+        paths[i] = std::move(path);
+    });
+    return paths;
+}
+
+// ================ Bidirectional Dijkstra ================= //
+std::vector<int> RoadNetwork::bidirectionalSearch(int src, int dest, const WeightProfile& profile,
+                                                  SearchWorkspace& workspace, SearchStats* stats) const {
+    const double INF = std::numeric_limits<double>::max();
+    std::vector<int> path;
+
+    std::vector<double>& distF = workspace.distF;
+    std::vector<double>& distB = workspace.distB;
+    std::vector<int>& parentF = workspace.parentF;
+    std::vector<int>& parentB = workspace.parentB;   // parentB[v]: next node towards dest
+    std::vector<bool>& settledF = workspace.settledF;
+    std::vector<bool>& settledB = workspace.settledB;
+    std::vector<int>& touched = workspace.touched;
+
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pqF, pqB;
+
+    distF[src] = 0.0;
+    distB[dest] = 0.0;
+    touched.push_back(src);
+    touched.push_back(dest);
+    pqF.push({0.0, src});
+    pqB.push({0.0, dest});
+
+    // best: length of the shortest s-t path seen so far, through meet
+    double best = (src == dest) ? 0.0 : INF;
+    int meet = (src == dest) ? src : -1;
+    int settled = 0;
+
+    while (!pqF.empty() && !pqB.empty()) {
+        // No unsettled pair of labels can form a path shorter than best
+        if (pqF.top().first + pqB.top().first >= best) break;
+
+        // Advance the direction with the smaller frontier key
+        bool forward = pqF.top().first <= pqB.top().first;
+        auto& pq = forward ? pqF : pqB;
+        auto& dist = forward ? distF : distB;
+        auto& other = forward ? distB : distF;
+        auto& parent = forward ? parentF : parentB;
+        auto& done = forward ? settledF : settledB;
+
+        int u = pq.top().second;
+        pq.pop();
+        if (done[u]) continue;
+        done[u] = true;
+        settled++;
+
+        int begin = forward ? offsets[u] : reverseOffsets[u];
+        int end = forward ? offsets[u + 1] : reverseOffsets[u + 1];
+        for (int i = begin; i < end; i++) {
+            int v = forward ? targets[i] : reverseSources[i];
+            double w = edgeCost(forward ? i : reverseEdges[i], profile);
+            double newDist = dist[u] + w;
+            if (newDist < dist[v]) {
+                if (dist[v] == INF) touched.push_back(v);
+                dist[v] = newDist;
+                parent[v] = u;
+                pq.push({newDist, v});
+                // Labels from both sides meet at v
+                if (other[v] != INF && newDist + other[v] < best) {
+                    best = newDist + other[v];
+                    meet = v;
+                }
+            }
+        }
     }
-    
-    // Reverse to get path from source to destination
+
+    if (stats) stats->settledNodes = settled;
+    if (meet == -1) return path;
+
+    // Splice: src .. meet from the forward tree, meet .. dest from the backward tree
+    for (int v = meet; v != -1; v = parentF[v]) path.push_back(v);
     std::reverse(path.begin(), path.end());
-    
+    for (int v = parentB[meet]; v != -1; v = parentB[v]) path.push_back(v);
     return path;
 }
 
+// ================ Many-to-Many Distance Matrix ================= //
+DistanceMatrix RoadNetwork::distanceMatrix(const std::vector<int>& sources,
+                                           const std::vector<int>& destinations,
+                                           const ContractionHierarchy* hierarchy,
+                                           bool withTravelTimes) const {
+    // Convert at the API boundary; unknown IDs stay unreachable
+    std::vector<int> src(sources.size()), dest(destinations.size());
+    for (size_t i = 0; i < sources.size(); i++) src[i] = index.toIndex(sources[i]);
+    for (size_t i = 0; i < destinations.size(); i++) dest[i] = index.toIndex(destinations[i]);
+    return distanceMatrixIndices(src, dest, hierarchy, withTravelTimes);
+}
+
+DistanceMatrix RoadNetwork::distanceMatrixIndices(const std::vector<int>& sources,
+                                                  const std::vector<int>& destinations,
+                                                  const ContractionHierarchy* hierarchy,
+                                                  bool withTravelTimes) const {
+    const double INF = std::numeric_limits<double>::max();
+    DistanceMatrix matrix;
+    int n = nodeCount();
+
+    if (hierarchy && hierarchy->isValidFor(*this) && !withTravelTimes) {
+        hierarchy->fillDistanceMatrix(sources, destinations, matrix);
+    } else {
+        matrix.rows = static_cast<int>(sources.size());
+        matrix.cols = static_cast<int>(destinations.size());
+        matrix.costs.assign(static_cast<size_t>(matrix.rows) * matrix.cols, INF);
+        if (withTravelTimes) matrix.travelTimes.assign(matrix.costs.size(), INF);
+
+        // Columns wanting each node; a search stops once all are settled
+        std::vector<std::vector<int>> columnsAt(n);
+        int distinctTargets = 0;
+        for (int c = 0; c < matrix.cols; c++) {
+            int t = destinations[c];
+            if (!finalized || t < 0 || t >= n) continue;
+            if (columnsAt[t].empty()) distinctTargets++;
+            columnsAt[t].push_back(c);
+        }
+
+        // One workspace for all sources, reset through the touched list
+        std::vector<double> distance(n, INF);
+        std::vector<double> elapsed(withTravelTimes ? n : 0, 0.0);   // travel time along the search tree
+        std::vector<bool> settled(n, false);
+        std::vector<int> touched;
+        typedef std::pair<double, int> QueueEntry;
+
+        for (int r = 0; r < matrix.rows; r++) {
+            int s = sources[r];
+            if (!finalized || s < 0 || s >= n) continue;
+            double* row = matrix.costs.data() + static_cast<size_t>(r) * matrix.cols;
+            double* timeRow = withTravelTimes ? matrix.travelTimes.data() + static_cast<size_t>(r) * matrix.cols
+                                              : nullptr;
+
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> pq;
+            distance[s] = 0.0;
+            if (timeRow) elapsed[s] = 0.0;
+            touched.push_back(s);
+            pq.push({0.0, s});
+            int remaining = distinctTargets;
+
+            while (!pq.empty() && remaining > 0) {
+                auto [d, u] = pq.top();
+                pq.pop();
+                if (settled[u]) continue;
+                settled[u] = true;
+
+                if (!columnsAt[u].empty()) {
+                    for (int c : columnsAt[u]) {
+                        row[c] = d;
+                        if (timeRow) timeRow[c] = elapsed[u];
+                    }
+                    remaining--;
+                }
+
+                for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                    int v = targets[e];
+                    double newDist = d + weights[e];
+                    if (newDist < distance[v]) {
+                        if (distance[v] == INF) touched.push_back(v);
+                        distance[v] = newDist;
+                        if (timeRow) elapsed[v] = elapsed[u] + times[e];
+                        pq.push({newDist, v});
+                    }
+                }
+            }
+
+            for (int t : touched) {
+                distance[t] = INF;
+                settled[t] = false;
+            }
+            touched.clear();
+        }
+    }
+    return matrix;
+}
+
 // ================ BFS Traversal ================= //
-std::vector<int> RoadNetwork::bfs(Node* startNode) {
+std::vector<int> RoadNetwork::bfs(const Node* startNode) const {
     std::queue<int> q;
     std::vector<int> r;
-    std::unordered_set<int> visited;
+    int start = index.toIndex(startNode->location.id);
+    if (!finalized || start < 0 || start >= nodeCount()) {
+        // Isolated node: only the start itself is reachable
+        r.push_back(startNode->location.id);
+        return r;
+    }
+    std::vector<bool> visited(nodeCount(), false);
 
     // Initialize queue with start node
-    q.push(startNode->location.id);
-    visited.insert(startNode->location.id);
+    q.push(start);
+    visited[start] = true;
 
     while(!q.empty()) {
         int current = q.front();
         q.pop();
-        r.push_back(current);
+        r.push_back(index.toId(current));
 
         // Enqueue unvisited neighbors
-        for (const auto& neighbor : adjList[current]) {
-            if (visited.find(neighbor.first) == visited.end()) {
-                visited.insert(neighbor.first);
-                q.push(neighbor.first);
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                q.push(neighbor);
             }
         }
     }
     return r;
-}   
+}
 // ================ DFS Traversal ================= //
-std::vector<int> RoadNetwork::dfs(Node* startNode) {
+std::vector<int> RoadNetwork::dfs(const Node* startNode) const {
     std::stack <int> s;
     std::vector<int> r;
-    std::unordered_set<int> visited;
+    int start = index.toIndex(startNode->location.id);
+    if (!finalized || start < 0 || start >= nodeCount()) {
+        r.push_back(startNode->location.id);
+        return r;
+    }
+    std::vector<bool> visited(nodeCount(), false);
 
     // Initialize stack with start node
-    s.push(startNode->location.id);
-    visited.insert(startNode->location.id);
+    s.push(start);
+    visited[start] = true;
 
     while(!s.empty()) {
         int current = s.top();
         s.pop();
-        
+
         // Process current node
-        r.push_back(current);
+        r.push_back(index.toId(current));
 
         // Push unvisited neighbors
-        for (const auto& neighbor : adjList[current]) {
-            if (visited.find(neighbor.first) == visited.end()) {
-                visited.insert(neighbor.first);
-                s.push(neighbor.first);
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                s.push(neighbor);
             }
         }
     }
     return r;
-}
\ No newline at end of file
+}
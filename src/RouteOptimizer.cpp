@@ -15,7 +15,7 @@ std::vector<Delivery> RouteOptimizer::activitySelection(const std::vector<Delive
     // Create a copy and sort by deadline
     std::vector<Delivery> sortedDeliveries = deliveries;
     std::sort(sortedDeliveries.begin(), sortedDeliveries.end(),
-              [](const Delivery& a, const Delivery& b) { return a.deadline < b.deadline; });
+              [](const Delivery& a, const Delivery& b) { return a.deadlineKey() < b.deadlineKey(); });
     
     // Select first activity
     selected.push_back(sortedDeliveries[0]);
@@ -23,7 +23,7 @@ std::vector<Delivery> RouteOptimizer::activitySelection(const std::vector<Delive
     // Greedily select non-overlapping activities
     for (size_t i = 1; i < sortedDeliveries.size(); i++) {
         // For simplicity, consider deliveries non-overlapping if they have different deadlines
-        if (sortedDeliveries[i].deadline != selected.back().deadline) {
+        if (sortedDeliveries[i].deadlineEpoch != selected.back().deadlineEpoch) {
             selected.push_back(sortedDeliveries[i]);
         }
     }
@@ -126,15 +126,7 @@ void RouteOptimizer::merge(std::vector<Delivery>& deliveries, int left, int mid,
     
     // Merge based on deadline (primary) and priority (secondary)
     while (i <= mid && j <= right) {
-        auto priorityValue = [](const std::string& p) -> int {
-            if (p == "High") return 3;
-            if (p == "Medium") return 2;
-            return 1;
-        };
-        
-        if (deliveries[i].deadline < deliveries[j].deadline ||
-            (deliveries[i].deadline == deliveries[j].deadline && 
-             priorityValue(deliveries[i].priority) > priorityValue(deliveries[j].priority))) {
+        if (deliveries[i].deadlineKey() < deliveries[j].deadlineKey()) {
             temp.push_back(deliveries[i++]);
         } else {
             temp.push_back(deliveries[j++]);
@@ -162,21 +154,13 @@ std::vector<Delivery> RouteOptimizer::quickSort(std::vector<Delivery>& deliverie
 }
 
 int RouteOptimizer::quickSortPartition(std::vector<Delivery>& deliveries, int low, int high) {
-    auto priorityValue = [](const std::string& p) -> int {
-        if (p == "High") return 3;
-        if (p == "Medium") return 2;
-        return 1;
-    };
-    
     // Choose last element as pivot
-    Delivery pivot = deliveries[high];
+    uint64_t pivotKey = deliveries[high].deadlineKey();
     int i = low - 1;
     
     for (int j = low; j < high; j++) {
         // Compare by deadline first, then priority
-        if (deliveries[j].deadline < pivot.deadline ||
-            (deliveries[j].deadline == pivot.deadline && 
-             priorityValue(deliveries[j].priority) > priorityValue(pivot.priority))) {
+        if (deliveries[j].deadlineKey() < pivotKey) {
             i++;
             std::swap(deliveries[i], deliveries[j]);
         }
@@ -1,20 +1,57 @@
 #include "SmartCitySystem.hpp"
 #include <iomanip>
+#include <unordered_map>
 
 SmartCityDeliverySystem::SmartCityDeliverySystem() 
-    : spatialIndex(nullptr), scheduler(nullptr) {}
+    : hubDistances(nullptr), spatialIndex(nullptr), scheduler(nullptr), bootedFromSnapshot(false) {}
 
 SmartCityDeliverySystem::~SmartCityDeliverySystem() {
+    if (hubDistances) delete hubDistances;
     if (spatialIndex) delete spatialIndex;
     if (scheduler) delete scheduler;
 }
 
+namespace {
+const char* const SNAPSHOT_PATH = "Data/city.snapshot";
+
+// Registries are filled by inserting the records in order, so a repeated
+// key holds its last record; the layout names that record per slot
+template<typename K, typename T, typename KeyOf>
+bool writeRegistry(SnapshotWriter& writer, SnapshotSection id, const ConcurrentHashTable<K, T>& registry,
+                   const std::vector<T>& records, KeyOf keyOf) {
+    std::unordered_map<K, int> recordOf;
+    for (size_t i = 0; i < records.size(); i++) recordOf[keyOf(records[i])] = static_cast<int>(i);
+    std::vector<int32_t> layout = registry.layout([&recordOf](const K& key) {
+        auto it = recordOf.find(key);
+        return it == recordOf.end() ? -1 : it->second;
+    });
+    if (layout.empty()) return false;
+    writer.addArray(id, layout);
+    return true;
+}
+
+template<typename K, typename T, typename KeyOf>
+bool readRegistry(const SnapshotReader& reader, SnapshotSection id, ConcurrentHashTable<K, T>& registry,
+                  const std::vector<T>& records, KeyOf keyOf) {
+    std::vector<int32_t> layout;
+    return reader.readArray(id, layout) &&
+           registry.restoreLayout(layout, records.size(), [&records, &keyOf](int32_t i) {
+               return std::pair<K, T>(keyOf(records[i]), records[i]);
+           });
+}
+
+const auto locationKey = [](const Location& loc) { return loc.id; };
+const auto vehicleKey = [](const Vehicle& vehicle) { return vehicle.id; };
+const auto deliveryKey = [](const Delivery& delivery) { return delivery.id; };
+const auto trafficKey = [](const TrafficEvent& event) { return event.road_id; };
+}
+
 void SmartCityDeliverySystem::initialize() {
     std::cout << "\n" << std::string(70, '=') << std::endl;
     std::cout << "   SMART CITY DELIVERY & TRAFFIC MANAGEMENT SYSTEM" << std::endl;
     std::cout << std::string(70, '=') << "\n" << std::endl;
     
-    // Load all data
+    // Load all data (from the snapshot when it is current)
     loadData();
     
     // Initialize spatial indexing
@@ -25,81 +62,272 @@ void SmartCityDeliverySystem::initialize() {
     
     // Build the road network graph
     buildRoadNetwork();
+    
+    // A fresh CSV build is kept for the next start
+    if (!bootedFromSnapshot) saveSnapshot(SNAPSHOT_PATH);
+    
+    // Load or preprocess the contraction hierarchy
+    prepareRoutingHierarchy();
+    
+    // Maintained shortest-path trees from depots and hubs
+    initializeHubTrees();
 }
 
 void SmartCityDeliverySystem::loadData() {
     std::cout << "[LOADING DATA]" << std::endl;
     
-    locations = FileUtils::loadLocations();
-    vehicles = FileUtils::loadVehicles();
-    deliveries = FileUtils::loadDeliveries();
-    trafficEvents = FileUtils::loadTrafficUpdates();
+    // Stamp the sources before reading them, so a file changed mid-load
+    // leaves the snapshot stale rather than silently out of date
+    sourceStamps = stampSourceFiles(FileUtils::dataFiles());
+    bootedFromSnapshot = loadSnapshot(SNAPSHOT_PATH);
+    if (bootedFromSnapshot) {
+        std::cout << "  ✓ Snapshot: loaded from " << SNAPSHOT_PATH << std::endl;
+    } else {
+        locations = FileUtils::loadLocations();
+        vehicles = FileUtils::loadVehicles();
+        deliveries = FileUtils::loadDeliveries(&workerPool);
+        trafficEvents = FileUtils::loadTrafficUpdates(&workerPool);
+        cityMap = FileUtils::loadCityMap();
+        
+        // Dense indexing: locations[i] is the location with index i
+        locationIndex.build(locations);
+        
+        // Endpoints are resolved once here; later stages only use the IDs
+        locationIndex.resolve(deliveries);
+        locationIndex.resolve(cityMap);
+    }
     
     std::cout << "  ✓ Locations: " << locations.size() << std::endl;
     std::cout << "  ✓ Vehicles: " << vehicles.size() << std::endl;
     std::cout << "  ✓ Deliveries: " << deliveries.size() << std::endl;
     std::cout << "  ✓ Traffic Events: " << trafficEvents.size() << std::endl;
+    std::cout << "  ✓ Roads: " << cityMap.size() << std::endl;
+    std::cout << "  ✓ Location Index: " << locationIndex.size() << " dense IDs" << std::endl;
+}
+
+// Restores the records, location index, frozen graph, QuadTree, registry
+// slot layouts and deadline BST; on any mismatch everything is reset and the
+// caller falls back to the CSVs
+bool SmartCityDeliverySystem::loadSnapshot(const std::string& path) {
+    SnapshotReader reader;
+    if (!reader.open(path, sourceStamps)) return false;
+    
+    spatialIndex = new QuadTree(0, 0, 180, 360);
+    bool restored = reader.read(locations) && reader.read(vehicles) && reader.read(deliveries) &&
+                    reader.read(trafficEvents) && reader.read(cityMap) &&
+                    locationIndex.readSnapshot(reader);
+    if (restored) {
+        roadNetwork.setLocationIndex(locationIndex);
+        roadNetwork.setNodes(locations);
+        restored = roadNetwork.readSnapshot(reader) && spatialIndex->readSnapshot(reader, locations) &&
+                   readRegistry(reader, SnapshotSection::LocationRegistry, locationRegistry, locations, locationKey) &&
+                   readRegistry(reader, SnapshotSection::VehicleRegistry, vehicleRegistry, vehicles, vehicleKey) &&
+                   readRegistry(reader, SnapshotSection::DeliveryRegistry, deliveryRegistry, deliveries, deliveryKey) &&
+                   readRegistry(reader, SnapshotSection::TrafficRegistry, trafficRegistry, trafficEvents, trafficKey) &&
+                   deliveryDeadlineTree.readSnapshot(reader, deliveries);   // last: nothing to undo after it
+    }
+    if (!restored) {
+        std::cerr << "Ignoring unreadable snapshot: " << path << std::endl;
+        locations.clear();
+        vehicles.clear();
+        deliveries.clear();
+        trafficEvents.clear();
+        cityMap.clear();
+        locationIndex.clear();
+        locationRegistry.clear();
+        vehicleRegistry.clear();
+        deliveryRegistry.clear();
+        trafficRegistry.clear();
+        roadNetwork = RoadNetwork();
+        delete spatialIndex;
+        spatialIndex = nullptr;
+    }
+    return restored;
+}
+
+void SmartCityDeliverySystem::saveSnapshot(const std::string& path) {
+    std::cout << "\n[WRITING CITY SNAPSHOT]" << std::endl;
+    
+    SnapshotWriter writer;
+    writer.add(locations);
+    writer.add(vehicles);
+    writer.add(deliveries);
+    writer.add(trafficEvents);
+    writer.add(cityMap);
+    locationIndex.writeSnapshot(writer);
+    roadNetwork.writeSnapshot(writer);
+    bool complete = spatialIndex->writeSnapshot(writer, locations) &&
+        writeRegistry(writer, SnapshotSection::LocationRegistry, locationRegistry, locations, locationKey) &&
+        writeRegistry(writer, SnapshotSection::VehicleRegistry, vehicleRegistry, vehicles, vehicleKey) &&
+        writeRegistry(writer, SnapshotSection::DeliveryRegistry, deliveryRegistry, deliveries, deliveryKey) &&
+        writeRegistry(writer, SnapshotSection::TrafficRegistry, trafficRegistry, trafficEvents, trafficKey) &&
+        deliveryDeadlineTree.writeSnapshot(writer, deliveries);
+    if (complete && writer.save(path, sourceStamps)) {
+        std::cout << "  ✓ Snapshot: saved to " << path << std::endl;
+    } else {
+        std::cout << "  ✓ Snapshot: not saved (next start parses the CSVs again)" << std::endl;
+    }
 }
 
 void SmartCityDeliverySystem::initializeSpatialIndex() {
     std::cout << "\n[INITIALIZING SPATIAL INDEXING]" << std::endl;
     
-    // Build location registry (O(1) lookup)
-    for (const auto& loc : locations) {
-        locationRegistry.insert(loc.id, loc);
+    // A snapshot boot has already placed the registries and the deadline BST
+    if (!bootedFromSnapshot) {
+        // Build location registry (O(1) lookup)
+        for (const auto& loc : locations) {
+            locationRegistry.insert(loc.id, loc);
+        }
+        
+        // Build vehicle registry
+        for (const auto& vehicle : vehicles) {
+            vehicleRegistry.insert(vehicle.id, vehicle);
+        }
+        
+        // Build delivery registry
+        for (const auto& delivery : deliveries) {
+            deliveryRegistry.insert(delivery.id, delivery);
+        }
+        
+        // Build traffic registry
+        for (const auto& event : trafficEvents) {
+            trafficRegistry.insert(event.road_id, event);
+        }
     }
     std::cout << "  ✓ Location Registry: " << locationRegistry.size() << " entries" << std::endl;
-    
-    // Build vehicle registry
-    for (const auto& vehicle : vehicles) {
-        vehicleRegistry.insert(vehicle.id, vehicle);
-    }
     std::cout << "  ✓ Vehicle Registry: " << vehicleRegistry.size() << " entries" << std::endl;
-    
-    // Build delivery registry
-    for (const auto& delivery : deliveries) {
-        deliveryRegistry.insert(delivery.id, delivery);
-    }
     std::cout << "  ✓ Delivery Registry: " << deliveryRegistry.size() << " entries" << std::endl;
-    
-    // Build traffic registry
-    for (const auto& event : trafficEvents) {
-        trafficRegistry.insert(event.road_id, event);
-    }
     std::cout << "  ✓ Traffic Registry: " << trafficRegistry.size() << " entries" << std::endl;
     
-    // Build QuadTree for geographic queries (assuming coords in -90 to 90, -180 to 180)
-    spatialIndex = new QuadTree(0, 0, 180, 360);
-    for (auto& loc : locations) {
-        spatialIndex->insert(&loc);
+    // Build QuadTree for geographic queries (assuming coords in -90 to 90, -180 to 180);
+    // a snapshot boot has already restored it
+    if (!spatialIndex) {
+        spatialIndex = new QuadTree(0, 0, 180, 360);
+        for (auto& loc : locations) {
+            spatialIndex->insert(&loc);
+        }
     }
-    std::cout << "  ✓ QuadTree Index: Built for " << locations.size() << " locations" << std::endl;
+    std::cout << "  ✓ QuadTree Index: " << (bootedFromSnapshot ? "Restored" : "Built") << " for "
+              << locations.size() << " locations" << std::endl;
     
     // Build BST for deadline-based queries
-    for (const auto& delivery : deliveries) {
-        deliveryDeadlineTree.insert(delivery);
+    if (!bootedFromSnapshot) {
+        for (const auto& delivery : deliveries) {
+            deliveryDeadlineTree.insert(delivery);
+        }
     }
-    std::cout << "  ✓ Deadline BST: Built for " << deliveries.size() << " deliveries" << std::endl;
+    std::cout << "  ✓ Deadline BST: " << (bootedFromSnapshot ? "Restored" : "Built") << " for "
+              << deliveries.size() << " deliveries" << std::endl;
 }
 
 void SmartCityDeliverySystem::buildRoadNetwork() {
     std::cout << "\n[BUILDING ROAD NETWORK GRAPH]" << std::endl;
     
-    auto cityMap = FileUtils::loadCityMap();
-    
-    // Add edges to graph
-    for (const auto& edge : cityMap) {
-        int srcId = roadNetwork.getLocationIdByName(edge.source, locations);
-        int destId = roadNetwork.getLocationIdByName(edge.destination, locations);
+    // A snapshot boot restored the frozen graph, profiles included
+    int profiled = roadNetwork.profileCount();
+    if (!roadNetwork.isFinalized()) {
+        // Graph nodes share the dense location indexing and carry coordinates for A*
+        roadNetwork.setLocationIndex(locationIndex);
+        roadNetwork.setNodes(locations);
         
-        if (srcId != -1 && destId != -1) {
+        // Static weight per road ID (City_map data row), -1 where no graph
+        // edge carries the ID: rows the loader dropped leave gaps
+        int roadLimit = 1;
+        for (const auto& edge : cityMap) roadLimit = std::max(roadLimit, edge.road_id + 1);
+        std::vector<double> baseWeights(roadLimit, -1.0);
+        for (const auto& edge : cityMap) {
+            int srcId = edge.sourceId;
+            int destId = edge.destinationId;
+            
             // Use weighted average of distance and traffic time
             double weight = (edge.distance + edge.traffic_time) / 2.0;
-            roadNetwork.addEdge(srcId, destId, weight);
+            
+            // Keep the original metrics for the alternative weight profiles;
+            // the road ID is what traffic updates refer to
+            if (srcId != -1 && destId != -1) {
+                baseWeights[edge.road_id] = weight;
+                roadNetwork.addEdge(srcId, destId, weight,
+                                    EdgeMetrics{edge.distance, edge.traffic_congestion, edge.traffic_time},
+                                    edge.road_id);
+            }
         }
+        
+        // Profiles are staged first so the freeze lays them out in one pass
+        applyTrafficProfiles(baseWeights);
+        
+        // Freeze the staged adjacency into the CSR layout used for routing
+        roadNetwork.finalize();
+        profiled = roadNetwork.profileCount();
     }
     
     std::cout << "  ✓ Road Network: " << cityMap.size() << " roads added" << std::endl;
+    std::cout << "  ✓ Travel-Time Profiles: " << profiled << " roads from "
+              << trafficEvents.size() << " traffic updates" << std::endl;
+    std::cout << "  ✓ CSR Layout: " << roadNetwork.nodeCount() << " nodes, "
+              << roadNetwork.edgeCount() << " edges" << std::endl;
+    std::cout << "  ✓ A* Heuristic Scale: " << roadNetwork.getHeuristicScale()
+              << " weight/km" << std::endl;
+}
+
+// Each traffic update is the road's weight at its time of day. Timestamps are
+// folded onto one day: updates from different dates form a single daily
+// pattern, and at the same time of day the later row of the feed wins. The
+// static weight anchors midnight unless the feed has a 00:00 update of its own.
+void SmartCityDeliverySystem::applyTrafficProfiles(const std::vector<double>& baseWeights) {
+    std::vector<std::vector<ProfilePoint>> profiles(baseWeights.size());
+    for (const auto& event : trafficEvents) {
+        int road = event.road_id;
+        long long when = FileUtils::parseTimestamp(event.timestamp);
+        if (road <= 0 || road >= static_cast<int>(baseWeights.size()) || baseWeights[road] < 0.0 || when < 0) {
+            std::cerr << "Skipping traffic update for road " << event.road_id << std::endl;
+            continue;
+        }
+        profiles[road].push_back({static_cast<int>(when % RoadNetwork::SECONDS_PER_DAY),
+                                  static_cast<double>(event.new_weight)});
+    }
+    
+    for (size_t road = 0; road < profiles.size(); road++) {
+        if (profiles[road].empty()) continue;
+        // First, so a real midnight update given later replaces it
+        profiles[road].insert(profiles[road].begin(), ProfilePoint{0, baseWeights[road]});
+        roadNetwork.setTravelTimeProfile(static_cast<int>(road), profiles[road]);
+    }
+}
+
+void SmartCityDeliverySystem::prepareRoutingHierarchy() {
+    std::cout << "\n[PREPARING ROUTING HIERARCHY]" << std::endl;
+    
+    const std::string cachePath = "Data/City_map.ch";
+    if (routingHierarchy.load(cachePath, roadNetwork)) {
+        std::cout << "  ✓ Contraction Hierarchy: loaded from " << cachePath << std::endl;
+    } else {
+        // Missing or built for a different graph: preprocess and cache
+        routingHierarchy.build(roadNetwork);
+        if (routingHierarchy.save(cachePath)) {
+            std::cout << "  ✓ Contraction Hierarchy: built and saved to " << cachePath << std::endl;
+        } else {
+            std::cout << "  ✓ Contraction Hierarchy: built (not cached)" << std::endl;
+        }
+    }
+    std::cout << "  ✓ Shortcuts: " << routingHierarchy.getShortcutCount() << std::endl;
+    
+    scheduler->setContractionHierarchy(&routingHierarchy);
+}
+
+void SmartCityDeliverySystem::initializeHubTrees() {
+    std::cout << "\n[MAINTAINING HUB SHORTEST-PATH TREES]" << std::endl;
+    
+    hubDistances = new DynamicShortestPaths(&roadNetwork);
+    
+    // Roots: hub locations plus every vehicle depot (start location)
+    for (const auto& loc : locations) {
+        if (loc.details == "hub") hubDistances->addRoot(loc.id);
+    }
+    for (const auto& vehicle : vehicles) {
+        int depotId = roadNetwork.getLocationIdByName(vehicle.licensePlate, locations);
+        if (depotId != -1) hubDistances->addRoot(depotId);
+    }
+    std::cout << "  ✓ Hub Trees: " << hubDistances->rootCount() << " roots maintained" << std::endl;
 }
 
 void SmartCityDeliverySystem::runDeliveryOptimization() {
@@ -130,12 +358,21 @@ void SmartCityDeliverySystem::runDeliveryOptimization() {
     // Phase 4: Assign deliveries to vehicles
     std::cout << "\n  Phase 4: Vehicle Assignment..." << std::endl;
     int assignedCount = 0;
-    for (size_t i = 0; i < selectedDeliveries.size() && i < vehicles.size(); i++) {
+    int queued = scheduler->addDeliveries(selectedDeliveries);
+    std::cout << "    ✓ Queued " << queued << " deliveries by priority" << std::endl;
+    std::vector<int> matches = scheduler->matchVehicles(selectedDeliveries, vehicles, locations);
+    std::vector<std::vector<int>> routes =
+        scheduler->calculateOptimalRoutes(selectedDeliveries, locations, workerPool);
+    std::cout << "    ✓ Routed " << routes.size() << " deliveries on "
+              << workerPool.size() << " worker thread(s)" << std::endl;
+    for (size_t i = 0; i < selectedDeliveries.size(); i++) {
+        if (matches[i] == -1) continue;
         bool assigned = scheduler->assignDeliveryToVehicle(
             selectedDeliveries[i].id,
-            vehicles[i].id,
+            matches[i],
             vehicles,
-            locations
+            locations,
+            routes[i]
         );
         if (assigned) assignedCount++;
     }
@@ -162,21 +399,65 @@ void SmartCityDeliverySystem::demonstratePathfinding() {
     std::cout << "  Finding shortest path from " << locations[0].name 
               << " to " << locations[1].name << "..." << std::endl;
     
-    std::vector<int> path = roadNetwork.shortestPath(srcId, destId);
+    SearchStats dijkstraStats, aStarStats, hierarchyStats;
+    std::vector<int> path = roadNetwork.shortestPath(srcId, destId, SearchMode::AStar, &aStarStats);
+    roadNetwork.shortestPath(srcId, destId, SearchMode::Dijkstra, &dijkstraStats);
+    routingHierarchy.shortestPath(srcId, destId, &hierarchyStats);
     
     if (!path.empty()) {
         std::cout << "    ✓ Path found with " << path.size() << " nodes: ";
         for (size_t i = 0; i < path.size(); i++) {
-            Location loc;
-            if (locationRegistry.find(path[i], loc)) {
-                std::cout << loc.name;
+            int index = locationIndex.toIndex(path[i]);
+            if (index != -1) {
+                std::cout << locations[index].name;
                 if (i < path.size() - 1) std::cout << " → ";
             }
         }
         std::cout << std::endl;
+        std::cout << "    ✓ Settled nodes: A* " << aStarStats.settledNodes
+                  << " vs Dijkstra " << dijkstraStats.settledNodes
+                  << " vs CH " << hierarchyStats.settledNodes << std::endl;
     } else {
         std::cout << "    ✗ No path found" << std::endl;
     }
+    
+    // Same trip under each weight profile, no re-preprocessing in between
+    struct NamedProfile { const char* name; WeightProfile profile; };
+    const NamedProfile profiles[] = {
+        {"Fastest", WeightProfile::fastest()},
+        {"Shortest", WeightProfile::shortest()},
+        {"Least congested", WeightProfile::leastCongested()},
+    };
+    for (const auto& named : profiles) {
+        std::vector<int> profiledPath = roadNetwork.shortestPath(srcId, destId, SearchMode::AStar,
+                                                                 nullptr, named.profile);
+        std::cout << "    ✓ " << named.name << ": " << profiledPath.size() << " nodes, "
+                  << roadNetwork.pathCost(profiledPath, WeightProfile::fastest()) << " min, "
+                  << roadNetwork.pathCost(profiledPath, WeightProfile::shortest()) << " km" << std::endl;
+    }
+    
+    // Same trip at two departure times over the traffic-update profiles
+    const int departures[] = {8 * 3600 + 15 * 60, 12 * 3600};
+    std::ios savedFormat(nullptr);
+    savedFormat.copyfmt(std::cout);
+    for (int departure : departures) {
+        double arrival = 0.0;
+        std::vector<int> timedPath = roadNetwork.shortestPathAt(srcId, destId, departure,
+                                                                SearchMode::AStar, nullptr, &arrival);
+        std::cout << "    ✓ Depart " << std::setfill('0') << std::setw(2) << departure / 3600 << ":"
+                  << std::setw(2) << (departure % 3600) / 60 << std::setfill(' ') << ": ";
+        if (timedPath.empty()) {
+            std::cout << "no path" << std::endl;
+            continue;
+        }
+        for (size_t i = 0; i < timedPath.size(); i++) {
+            std::cout << locations[locationIndex.toIndex(timedPath[i])].name;
+            if (i < timedPath.size() - 1) std::cout << " → ";
+        }
+        std::cout << " (" << std::fixed << std::setprecision(1) << (arrival - departure) / 60.0
+                  << " min)" << std::endl;
+    }
+    std::cout.copyfmt(savedFormat);
 }
 
 void SmartCityDeliverySystem::demonstrateSpatialQueries() {
@@ -223,6 +504,70 @@ void SmartCityDeliverySystem::demonstrateClosestPairAnalysis() {
     }
 }
 
+void SmartCityDeliverySystem::demonstrateTrafficStream() {
+    std::cout << "\n[STREAMING TRAFFIC UPDATES]" << std::endl;
+    
+    // Replay the traffic export through the streaming stage: each road's live
+    // weight becomes its latest reported value
+    TrafficStream stream(roadNetwork);
+    if (!stream.start("Data/Traffic_updates.csv")) return;
+    bool caughtUp = stream.waitUntilIdle(5000);
+    stream.stop();
+    
+    TrafficStreamStats stats = stream.getStats();
+    std::ios savedFormat(nullptr);
+    savedFormat.copyfmt(std::cout);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  ✓ Streamed " << stats.updatesAccepted << " updates (" << stats.coalesced
+              << " coalesced, " << stats.rejected << " rejected) in " << stats.batches << " batch(es)"
+              << (caughtUp ? "" : ", input still pending") << std::endl;
+    std::cout << "  ✓ Live weights applied to " << stats.roadsApplied << " roads, max "
+              << stats.maxLatencyMs << " ms after receipt" << std::endl;
+    std::cout.copyfmt(savedFormat);
+    
+    hubDistances->refresh();
+    std::cout << "  ✓ Hub Trees: " << hubDistances->getLastRepairedNodes() << " nodes repaired" << std::endl;
+    
+    // The first demo trip again, now on the live weights
+    if (locations.size() < 2) return;
+    std::vector<int> path = roadNetwork.shortestPath(locations[0].id, locations[1].id, SearchMode::AStar);
+    std::cout << "  ✓ Live route " << locations[0].name << " → " << locations[1].name << ": ";
+    if (path.empty()) {
+        std::cout << "no path" << std::endl;
+    } else {
+        std::cout << path.size() << " nodes, cost " << roadNetwork.pathCost(path) << std::endl;
+    }
+}
+
+void SmartCityDeliverySystem::streamTrafficUpdates(const std::string& path, int seconds) {
+    std::cout << "\n[STREAMING TRAFFIC UPDATES] " << path << " for " << seconds << "s" << std::endl;
+    
+    TrafficStream stream(roadNetwork);
+    if (!stream.start(path)) return;
+    std::ios savedFormat(nullptr);
+    savedFormat.copyfmt(std::cout);
+    std::cout << std::fixed << std::setprecision(1);
+    for (int second = 1; second <= seconds; second++) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        
+        // Hub trees consume the graph's change log, so they repair under the write lock
+        int repaired = 0;
+        {
+            auto guard = stream.writeLock();
+            hubDistances->refresh();
+            repaired = hubDistances->getLastRepairedNodes();
+        }
+        TrafficStreamStats stats = stream.getStats();
+        std::cout << "  [" << second << "s] " << stats.updatesAccepted << " updates, "
+                  << static_cast<long long>(stats.updatesPerSecond()) << "/s, "
+                  << stats.batches << " batches, max latency " << stats.maxLatencyMs << " ms, "
+                  << repaired << " hub nodes repaired" << std::endl;
+    }
+    std::cout.copyfmt(savedFormat);
+    stream.stop();
+    stream.printStatistics();
+}
+
 void SmartCityDeliverySystem::displayAnalytics() {
     std::cout << "\n[SYSTEM ANALYTICS & METRICS]" << std::endl;
     
@@ -242,7 +587,7 @@ void SmartCityDeliverySystem::displayAnalytics() {
     int highPriority = 0;
     for (const auto& d : deliveries) {
         totalWeight += d.weight;
-        if (d.priority == "High") highPriority++;
+        if (d.level == PriorityLevel::High) highPriority++;
     }
     std::cout << "    Total Weight: " << totalWeight << " kg" << std::endl;
     std::cout << "    High Priority: " << highPriority << std::endl;
@@ -255,6 +600,12 @@ void SmartCityDeliverySystem::displayAnalytics() {
     
     std::cout << "\n  Pending Deliveries:" << std::endl;
     std::cout << "    Count: " << scheduler->getPendingCount() << std::endl;
+    
+    const RouteCacheStats& cacheStats = scheduler->getRouteCacheStats();
+    std::cout << "\n  Route Cache:" << std::endl;
+    std::cout << "    Hits: " << cacheStats.hits << ", Misses: " << cacheStats.misses
+              << ", Evictions: " << cacheStats.evictions
+              << ", Invalidations: " << cacheStats.invalidations << std::endl;
 }
 
 void SmartCityDeliverySystem::runFullSystem() {
@@ -263,6 +614,7 @@ void SmartCityDeliverySystem::runFullSystem() {
     demonstrateSpatialQueries();
     demonstrateClosestPairAnalysis();
     runDeliveryOptimization();
+    demonstrateTrafficStream();
     displayAnalytics();
     
     std::cout << "\n" << std::string(70, '=') << std::endl;
@@ -1,111 +1,197 @@
 #include "SpatialIndex.hpp"
+#include "CitySnapshot.hpp"
 #include <limits>
+#include <unordered_map>
 
 // ==================== QUADTREE IMPLEMENTATION ====================
 
 QuadTree::QuadTree(double centerX, double centerY, double width, double height) {
-    root = new Node(centerX, centerY, width, height);
+    addLeaf(centerX, centerY, width, height);
 }
 
-QuadTree::~QuadTree() {
-    deleteTree(root);
+int QuadTree::addLeaf(double cx, double cy, double w, double h) {
+    nodes.push_back({cx, cy, w, h, NONE, NONE});
+    return static_cast<int>(nodes.size()) - 1;
 }
 
-void QuadTree::deleteTree(Node* node) {
-    if (!node) return;
-    for (int i = 0; i < 4; i++) deleteTree(node->children[i]);
-    delete node;
+// Most leaves of a subdivision stay empty, so blocks are taken on first use
+int QuadTree::allocateBlock() {
+    int block;
+    if (!freeBlocks.empty()) {
+        block = freeBlocks.back();
+        freeBlocks.pop_back();
+    } else {
+        block = static_cast<int>(blocks.size());
+        blocks.emplace_back();
+    }
+    blocks[block].count = 0;
+    return block;
 }
 
 void QuadTree::insert(Location* location) {
-    insert(root, location);
+    insert(0, LeafEntry{location->longitude, location->latitude, location});
 }
 
-void QuadTree::insert(Node* node, Location* loc) {
-    if (!node) return;
-    
+void QuadTree::insert(int node, const LeafEntry& entry) {
     // Check bounds
-    double hw = node->width / 2, hh = node->height / 2;
-    if (loc->longitude < node->x - hw || loc->longitude > node->x + hw ||
-        loc->latitude < node->y - hh || loc->latitude > node->y + hh) return;
+    double hw = nodes[node].width / 2, hh = nodes[node].height / 2;
+    double x = nodes[node].x, y = nodes[node].y;
+    if (entry.longitude < x - hw || entry.longitude > x + hw ||
+        entry.latitude < y - hh || entry.latitude > y + hh) return;
     
     // Leaf node - add location or subdivide
-    if (!node->children[0]) {
-        if (node->locations.size() < MAX_CAPACITY) {
-            node->locations.push_back(loc);
+    if (nodes[node].firstChild == NONE) {
+        if (nodes[node].block == NONE) nodes[node].block = allocateBlock();
+        LeafBlock& leaf = blocks[nodes[node].block];
+        if (leaf.count < MAX_CAPACITY) {
+            leaf.entries[leaf.count++] = entry;
             return;
         }
-        // Subdivide into 4 quadrants
-        node->children[0] = new Node(node->x - hw/2, node->y + hh/2, hw, hh); // NW
-        node->children[1] = new Node(node->x + hw/2, node->y + hh/2, hw, hh); // NE
-        node->children[2] = new Node(node->x - hw/2, node->y - hh/2, hw, hh); // SW
-        node->children[3] = new Node(node->x + hw/2, node->y - hh/2, hw, hh); // SE
+        // Subdivide into 4 quadrants, allocated side by side (addLeaf may
+        // grow the arrays, so nothing is held by reference across it)
+        LeafBlock moved = leaf;
+        freeBlocks.push_back(nodes[node].block);
+        nodes[node].block = NONE;
+        int first = addLeaf(x - hw/2, y + hh/2, hw, hh); // NW
+        addLeaf(x + hw/2, y + hh/2, hw, hh);             // NE
+        addLeaf(x - hw/2, y - hh/2, hw, hh);             // SW
+        addLeaf(x + hw/2, y - hh/2, hw, hh);             // SE
+        nodes[node].firstChild = first;
         
         // Redistribute locations
-        for (auto loc : node->locations) {
-            for (int i = 0; i < 4; i++) insert(node->children[i], loc);
+        for (int e = 0; e < moved.count; e++) {
+            for (int i = 0; i < 4; i++) insert(first + i, moved.entries[e]);
         }
-        node->locations.clear();
     }
     
     // Insert into children
-    for (int i = 0; i < 4; i++) insert(node->children[i], loc);
+    int first = nodes[node].firstChild;
+    for (int i = 0; i < 4; i++) insert(first + i, entry);
 }
 
-std::vector<Location*> QuadTree::radiusSearch(double centerX, double centerY, double radius) {
+std::vector<Location*> QuadTree::radiusSearch(double centerX, double centerY, double radius) const {
     std::vector<Location*> result;
-    radiusSearch(root, centerX, centerY, radius, result);
+    radiusSearch(0, centerX, centerY, radius, result);
     return result;
 }
 
-void QuadTree::radiusSearch(Node* node, double cx, double cy, double r, std::vector<Location*>& result) {
-    if (!node) return;
+void QuadTree::radiusSearch(int node, double cx, double cy, double r, std::vector<Location*>& result) const {
+    const Node& quad = nodes[node];
     
     // Check if quadrant intersects circle
-    double hw = node->width / 2, hh = node->height / 2;
-    double closestX = std::max(node->x - hw, std::min(cx, node->x + hw));
-    double closestY = std::max(node->y - hh, std::min(cy, node->y + hh));
+    double hw = quad.width / 2, hh = quad.height / 2;
+    double closestX = std::max(quad.x - hw, std::min(cx, quad.x + hw));
+    double closestY = std::max(quad.y - hh, std::min(cy, quad.y + hh));
     
     if (distance(cx, cy, closestX, closestY) > r) return;
     
-    if (!node->children[0]) {
+    if (quad.firstChild == NONE) {
         // Leaf: check each location
-        for (auto loc : node->locations) {
-            if (distance(cx, cy, loc->longitude, loc->latitude) <= r) {
-                result.push_back(loc);
+        if (quad.block == NONE) return;
+        const LeafBlock& leaf = blocks[quad.block];
+        for (int e = 0; e < leaf.count; e++) {
+            if (distance(cx, cy, leaf.entries[e].longitude, leaf.entries[e].latitude) <= r) {
+                result.push_back(leaf.entries[e].location);
             }
         }
     } else {
         // Recurse to children
-        for (int i = 0; i < 4; i++) radiusSearch(node->children[i], cx, cy, r, result);
+        for (int i = 0; i < 4; i++) radiusSearch(quad.firstChild + i, cx, cy, r, result);
     }
 }
 
-Location* QuadTree::findNearest(double x, double y) {
+Location* QuadTree::findNearest(double x, double y) const {
     double minDist = std::numeric_limits<double>::max();
-    return findNearest(root, x, y, minDist, nullptr);
+    return findNearest(0, x, y, minDist, nullptr);
 }
 
-Location* QuadTree::findNearest(Node* node, double x, double y, double& minDist, Location* current) {
-    if (!node) return current;
-    
-    if (!node->children[0]) {
-        for (auto loc : node->locations) {
-            double dist = distance(x, y, loc->longitude, loc->latitude);
+Location* QuadTree::findNearest(int node, double x, double y, double& minDist, Location* current) const {
+    const Node& quad = nodes[node];
+    if (quad.firstChild == NONE) {
+        if (quad.block == NONE) return current;
+        const LeafBlock& leaf = blocks[quad.block];
+        for (int e = 0; e < leaf.count; e++) {
+            double dist = distance(x, y, leaf.entries[e].longitude, leaf.entries[e].latitude);
             if (dist < minDist) {
                 minDist = dist;
-                current = loc;
+                current = leaf.entries[e].location;
             }
         }
         return current;
     }
     
     for (int i = 0; i < 4; i++) {
-        current = findNearest(node->children[i], x, y, minDist, current);
+        current = findNearest(quad.firstChild + i, x, y, minDist, current);
     }
     return current;
 }
 
+// Leaf blocks are written as MAX_CAPACITY + 1 ints each: the entry count,
+// then the location indices (released blocks have a count of 0)
+bool QuadTree::writeSnapshot(SnapshotWriter& writer, const std::vector<Location>& locations) const {
+    static_assert(std::is_trivially_copyable<Node>::value && sizeof(Node) == 40, "snapshot node layout");
+    const int stride = MAX_CAPACITY + 1;
+    std::vector<int32_t> entries(blocks.size() * stride, 0);
+    for (size_t b = 0; b < blocks.size(); b++) {
+        entries[b * stride] = blocks[b].count;
+        for (int e = 0; e < blocks[b].count; e++) {
+            // Only locations stored in the vector can be written as indices
+            const Location* loc = blocks[b].entries[e].location;
+            if (loc < locations.data() || loc >= locations.data() + locations.size()) return false;
+            entries[b * stride + 1 + e] = static_cast<int32_t>(loc - locations.data());
+        }
+    }
+    writer.addArray(SnapshotSection::QuadTreeNodes, nodes);
+    writer.addArray(SnapshotSection::QuadTreeEntries, entries);
+    return true;
+}
+
+bool QuadTree::readSnapshot(const SnapshotReader& reader, std::vector<Location>& locations) {
+    const int stride = MAX_CAPACITY + 1;
+    std::vector<Node> loadedNodes;
+    std::vector<int32_t> entries;
+    if (!reader.readArray(SnapshotSection::QuadTreeNodes, loadedNodes) ||
+        !reader.readArray(SnapshotSection::QuadTreeEntries, entries) ||
+        loadedNodes.empty() || entries.size() % stride != 0) {
+        return false;
+    }
+    
+    // Children always come after their parent, so every walk terminates;
+    // each block belongs to at most one leaf
+    size_t blockCount = entries.size() / stride;
+    std::vector<bool> owned(blockCount, false);
+    for (size_t i = 0; i < loadedNodes.size(); i++) {
+        const Node& node = loadedNodes[i];
+        if (node.firstChild == NONE) {
+            if (node.block == NONE) continue;
+            if (node.block < 0 || static_cast<size_t>(node.block) >= blockCount || owned[node.block]) return false;
+            owned[node.block] = true;
+        } else if (node.block != NONE || node.firstChild <= static_cast<int>(i) ||
+                   static_cast<size_t>(node.firstChild) + 4 > loadedNodes.size()) {
+            return false;
+        }
+    }
+    
+    std::vector<LeafBlock> loadedBlocks(blockCount);
+    std::vector<int> loadedFree;
+    for (size_t b = 0; b < blockCount; b++) {
+        const int32_t* record = entries.data() + b * stride;
+        if (record[0] < 0 || record[0] > MAX_CAPACITY) return false;
+        loadedBlocks[b].count = record[0];
+        for (int e = 0; e < record[0]; e++) {
+            if (record[1 + e] < 0 || static_cast<size_t>(record[1 + e]) >= locations.size()) return false;
+            Location* loc = &locations[record[1 + e]];
+            loadedBlocks[b].entries[e] = LeafEntry{loc->longitude, loc->latitude, loc};
+        }
+        if (!owned[b]) loadedFree.push_back(static_cast<int>(b));
+    }
+    
+    nodes.swap(loadedNodes);
+    blocks.swap(loadedBlocks);
+    freeBlocks.swap(loadedFree);
+    return true;
+}
+
 // ==================== BINARY SEARCH TREE IMPLEMENTATION ====================
 
 BST::BST() : root(nullptr) {}
@@ -128,7 +214,7 @@ void BST::insert(const Delivery& delivery) {
 BST::Node* BST::insertHelper(Node* node, const Delivery& delivery) {
     if (!node) return new Node(delivery);
     
-    if (delivery.deadline < node->delivery.deadline) {
+    if (delivery.deadlineKey() < node->delivery.deadlineKey()) {
         node->left = insertHelper(node->left, delivery);
     } else {
         node->right = insertHelper(node->right, delivery);
@@ -149,15 +235,22 @@ BST::Node* BST::findMin(Node* node) {
 
 std::vector<Delivery> BST::rangeSearch(const std::string& startDeadline, const std::string& endDeadline) {
     std::vector<Delivery> result;
-    collectInRange(root, startDeadline, endDeadline, result);
+    long long start = FileUtils::parseTimestamp(startDeadline);
+    long long end = FileUtils::parseTimestamp(endDeadline);
+    if (start < 0 || end < 0) {
+        std::cerr << "Invalid deadline range: " << startDeadline << " - " << endDeadline << std::endl;
+        return result;
+    }
+    collectInRange(root, start, end, result);
     return result;
 }
 
-void BST::collectInRange(Node* node, const std::string& start, const std::string& end, 
+void BST::collectInRange(Node* node, long long start, long long end, 
                          std::vector<Delivery>& result) {
     if (!node) return;
     
-    if (node->delivery.deadline >= start && node->delivery.deadline <= end) {
+    long long deadline = node->delivery.deadlineEpoch;
+    if (deadline >= start && deadline <= end) {
         result.push_back(node->delivery);
     }
     collectInRange(node->left, start, end, result);
@@ -200,6 +293,75 @@ BST::Node* BST::deleteHelper(Node* node, const std::string& id) {
     return node;
 }
 
+// Nodes are matched to records by delivery ID; a repeated ID takes its
+// records in order
+bool BST::writeSnapshot(SnapshotWriter& writer, const std::vector<Delivery>& deliveries) const {
+    std::unordered_map<std::string, std::vector<int32_t>> recordsById;
+    for (size_t i = deliveries.size(); i-- > 0;) {
+        recordsById[deliveries[i].id].push_back(static_cast<int32_t>(i));
+    }
+    
+    // Preorder with an explicit stack: a degenerate (sorted) tree is as deep as it is large
+    std::vector<int32_t> shape;
+    std::vector<std::pair<const Node*, int>> pending;   // node, triple field that links to it
+    if (root) pending.push_back({root, -1});
+    while (!pending.empty()) {
+        auto [node, link] = pending.back();
+        pending.pop_back();
+        int32_t index = static_cast<int32_t>(shape.size() / 3);
+        if (link >= 0) shape[link] = index;
+        auto records = recordsById.find(node->delivery.id);
+        if (records == recordsById.end() || records->second.empty()) return false;
+        shape.push_back(records->second.back());
+        shape.push_back(-1);
+        shape.push_back(-1);
+        records->second.pop_back();
+        if (node->right) pending.push_back({node->right, index * 3 + 2});
+        if (node->left) pending.push_back({node->left, index * 3 + 1});
+    }
+    writer.addArray(SnapshotSection::DeadlineTree, shape);
+    return true;
+}
+
+bool BST::readSnapshot(const SnapshotReader& reader, const std::vector<Delivery>& deliveries) {
+    std::vector<int32_t> shape;
+    if (!reader.readArray(SnapshotSection::DeadlineTree, shape) || shape.size() % 3 != 0) return false;
+    
+    // Children come after their parent and each node has one parent, so the
+    // triples form one tree rooted at 0; every key must also lie in the range
+    // its path from the root allows (left: smaller, right: not smaller)
+    size_t count = shape.size() / 3;
+    std::vector<bool> linked(count, false);
+    std::vector<uint64_t> low(count, 0), high(count, std::numeric_limits<uint64_t>::max());
+    for (size_t i = 0; i < count; i++) {
+        int32_t record = shape[i * 3];
+        if (record < 0 || static_cast<size_t>(record) >= deliveries.size() || (i > 0 && !linked[i])) return false;
+        uint64_t key = deliveries[record].deadlineKey();
+        if (key < low[i] || key > high[i]) return false;
+        for (int side = 1; side <= 2; side++) {
+            int32_t child = shape[i * 3 + side];
+            if (child == -1) continue;
+            if (child <= static_cast<int32_t>(i) || static_cast<size_t>(child) >= count || linked[child]) return false;
+            if (side == 1 && key == 0) return false;
+            linked[child] = true;
+            low[child] = (side == 1) ? low[i] : key;
+            high[child] = (side == 1) ? key - 1 : high[i];
+        }
+    }
+    
+    std::vector<Node*> restored(count);
+    for (size_t i = 0; i < count; i++) {
+        restored[i] = new Node(deliveries[shape[i * 3]]);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (shape[i * 3 + 1] != -1) restored[i]->left = restored[shape[i * 3 + 1]];
+        if (shape[i * 3 + 2] != -1) restored[i]->right = restored[shape[i * 3 + 2]];
+    }
+    deleteTree(root);
+    root = count ? restored[0] : nullptr;
+    return true;
+}
+
 // ==================== SEGMENT TREE IMPLEMENTATION ====================
 
 SegmentTree::SegmentTree(const std::vector<int>& trafficDensities) {
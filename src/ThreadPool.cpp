@@ -0,0 +1,84 @@
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount) : stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threadCount = std::max(1, threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+// ================ Worker Loop ================ //
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            // Drain queued work before shutting down
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push([packaged] { (*packaged)(); });
+    }
+    available.notify_one();
+    return result;
+}
+
+// ================ Parallel For ================ //
+void ThreadPool::parallelFor(size_t count, const std::function<void(int, size_t)>& body) {
+    if (count == 0) return;
+
+    // One task per worker slot; tasks pull indices so uneven items balance out
+    std::atomic<size_t> next(0);
+    int taskCount = static_cast<int>(std::min(count, workers.size()));
+    std::vector<std::future<void>> pending;
+    for (int slot = 0; slot < taskCount; slot++) {
+        pending.push_back(submit([&next, &body, count, slot] {
+            for (size_t i = next++; i < count; i = next++) {
+                body(slot, i);
+            }
+        }));
+    }
+
+    // Wait for every task before rethrowing, the body captures locals
+    std::exception_ptr error;
+    for (auto& task : pending) {
+        try {
+            task.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
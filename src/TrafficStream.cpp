@@ -0,0 +1,289 @@
+#include "TrafficStream.hpp"
+#include "CsvReader.hpp"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TrafficStream::TrafficStream(RoadNetwork& network, int windowMs)
+    : network(network), knownRoads(network.roadLimit(), false), window(std::max(1, windowMs)),
+#ifndef _WIN32
+      descriptor(-1),
+#endif
+      regularFile(false), stopping(false), idle(true), readOffset(0), appliedOffset(0), pendingWeight(network.roadLimit(), 0.0),
+      pendingFlag(network.roadLimit(), false), headerAllowed(false) {
+    // Validated on the reader thread without touching the graph
+    for (int roadId = 1; roadId < network.roadLimit(); roadId++) {
+        knownRoads[roadId] = network.roadSlot(roadId) != -1;
+    }
+}
+
+TrafficStream::~TrafficStream() {
+    stop();
+}
+
+// ================ Control ================ //
+bool TrafficStream::start(const std::string& path, bool fromStart) {
+    if (reader.joinable()) return false;
+#ifndef _WIN32
+    // Non-blocking, so opening a pipe does not wait for a writer and an
+    // idle reader can still notice stop()
+    descriptor = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (descriptor < 0) {
+        std::cerr << "Error opening traffic stream: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    regularFile = ::fstat(descriptor, &info) == 0 && S_ISREG(info.st_mode);
+    readOffset = 0;
+    if (!fromStart && regularFile) readOffset = ::lseek(descriptor, 0, SEEK_END);
+#else
+    input.open(path, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Error opening traffic stream: " << path << std::endl;
+        return false;
+    }
+    inputPath = path;
+    regularFile = std::filesystem::is_regular_file(path);
+    readOffset = 0;
+    if (!fromStart) {
+        input.seekg(0, std::ios::end);
+        readOffset = static_cast<long long>(input.tellg());
+    }
+#endif
+    appliedOffset = readOffset;
+    buffer.clear();
+    {
+        std::lock_guard<std::mutex> guard(statsMutex);
+        stats = TrafficStreamStats();
+    }
+    headerAllowed = fromStart;
+    started = Clock::now();
+    stopping = false;
+    idle = false;
+    reader = std::thread(&TrafficStream::run, this);
+    return true;
+}
+
+void TrafficStream::stop() {
+    if (!reader.joinable()) return;
+    stopping = true;
+    reader.join();
+#ifndef _WIN32
+    ::close(descriptor);
+    descriptor = -1;
+#else
+    input.close();
+#endif
+    idle = true;
+}
+
+bool TrafficStream::isRunning() const {
+    return reader.joinable() && !stopping;
+}
+
+// A file is caught up once every byte it holds now has been applied; the
+// idle flag alone could predate rows appended since. A pipe has no size,
+// so for it idle means nothing arrived in the last read.
+bool TrafficStream::waitUntilIdle(int timeoutMs) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        if (regularFile) {
+            long long size = inputSize();
+            if (size >= 0 && appliedOffset >= size) return true;
+        } else if (idle) {
+            return true;
+        }
+        if (!reader.joinable() || Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+long long TrafficStream::inputSize() const {
+#ifndef _WIN32
+    struct stat info;
+    if (descriptor < 0 || ::fstat(descriptor, &info) != 0) return -1;
+    return static_cast<long long>(info.st_size);
+#else
+    std::error_code error;
+    auto size = std::filesystem::file_size(inputPath, error);
+    return error ? -1 : static_cast<long long>(size);
+#endif
+}
+
+std::shared_lock<std::shared_mutex> TrafficStream::readLock() const {
+    return std::shared_lock<std::shared_mutex>(graphLock);
+}
+
+std::unique_lock<std::shared_mutex> TrafficStream::writeLock() const {
+    return std::unique_lock<std::shared_mutex>(graphLock);
+}
+
+// ================ Reader Thread ================ //
+long TrafficStream::readInput(char* buffer, size_t capacity) {
+#ifndef _WIN32
+    // Wait up to one window for data; nothing pending waits no longer than
+    // that either, so stop() is noticed promptly
+    int timeout = pendingRoads.empty() ? static_cast<int>(window.count()) : 0;
+    pollfd request{descriptor, POLLIN, 0};
+    if (::poll(&request, 1, timeout) <= 0) return 0;
+    ssize_t bytes = ::read(descriptor, buffer, capacity);
+    return bytes > 0 ? static_cast<long>(bytes) : 0;
+#else
+    input.read(buffer, capacity);
+    long bytes = static_cast<long>(input.gcount());
+    if (input.eof()) input.clear();   // keep following the file
+    return bytes;
+#endif
+}
+
+void TrafficStream::run() {
+    const size_t CHUNK = 1 << 16;
+    std::vector<char> chunk(CHUNK);
+    while (!stopping) {
+        long bytes = readInput(chunk.data(), CHUNK);
+        if (bytes > 0) {
+            idle = false;
+            readOffset += bytes;
+            lastInput = Clock::now();
+            buffer.append(chunk.data(), bytes);
+            consume();
+        } else if (regularFile && !buffer.empty() && Clock::now() - lastInput >= window) {
+            // A file that ends mid-row and stays quiet ends with an unterminated row
+            consumePartial();
+        }
+        // Close the window when it is full or the input has gone quiet: a
+        // burst is coalesced, a trickle is applied right away
+        if (!pendingRoads.empty() && (bytes == 0 || Clock::now() - windowStart >= window)) {
+            flush();
+        }
+        if (bytes == 0) {
+            // End of the input for now (or a pipe without writers)
+            if (buffer.empty()) appliedOffset = readOffset;
+            idle = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    // Rows still arriving after stop() are left unread
+    consumePartial();
+    flush();
+    appliedOffset = readOffset;
+}
+
+void TrafficStream::consumePartial() {
+    if (buffer.empty()) return;
+    buffer.push_back('\n');
+    consume();
+}
+
+void TrafficStream::consume() {
+    size_t end = buffer.rfind('\n');
+    if (end == std::string::npos) return;
+    std::string_view complete(buffer.data(), end + 1);
+    TrafficStreamStats counts;
+    size_t position = 0;
+    while (position < complete.size()) {
+        size_t newline = complete.find('\n', position);
+        queueUpdate(complete.substr(position, newline - position), counts);
+        position = newline + 1;
+        counts.linesRead++;
+    }
+    buffer.erase(0, end + 1);
+
+    // Published once per read, not per row
+    std::lock_guard<std::mutex> guard(statsMutex);
+    stats.linesRead += counts.linesRead;
+    stats.updatesAccepted += counts.updatesAccepted;
+    stats.rejected += counts.rejected;
+    stats.coalesced += counts.coalesced;
+}
+
+void TrafficStream::queueUpdate(std::string_view line, TrafficStreamStats& counts) {
+    bool header = headerAllowed;
+    headerAllowed = false;
+    CsvReader row(line);
+    if (!row.nextRow(fields) || (fields.size() == 1 && fields[0].empty())) return;   // blank row
+
+    int roadId = 0, weight = 0;
+    bool parsed = fields.size() >= 2 && CsvReader::parseInt(fields[0], roadId) &&
+                  CsvReader::parseInt(fields[1], weight);
+    if (!parsed && header) return;   // column names of a replayed export
+    // Searches rely on positive weights, so zero or negative ones are rejected
+    if (!parsed || weight <= 0 || roadId <= 0 || roadId >= static_cast<int>(knownRoads.size()) ||
+        !knownRoads[roadId]) {
+        counts.rejected++;
+        return;
+    }
+
+    // Last write wins within the window
+    if (pendingRoads.empty()) windowStart = Clock::now();
+    counts.updatesAccepted++;
+    if (pendingFlag[roadId]) {
+        counts.coalesced++;
+    } else {
+        pendingFlag[roadId] = true;
+        pendingRoads.push_back(roadId);
+    }
+    pendingWeight[roadId] = weight;
+}
+
+void TrafficStream::flush() {
+    if (pendingRoads.empty()) return;
+    // Assembled outside the lock, which then covers only the weight writes
+    batch.clear();
+    for (int roadId : pendingRoads) {
+        batch.push_back({roadId, pendingWeight[roadId]});
+        pendingFlag[roadId] = false;
+    }
+    Clock::time_point lockStart;
+    {
+        std::unique_lock<std::shared_mutex> guard(graphLock);
+        lockStart = Clock::now();
+        network.updateRoadWeights(batch);
+    }
+    Clock::time_point applied = Clock::now();
+    double applyMs = std::chrono::duration<double, std::milli>(applied - lockStart).count();
+    double latencyMs = std::chrono::duration<double, std::milli>(applied - windowStart).count();
+
+    std::lock_guard<std::mutex> guard(statsMutex);
+    stats.batches++;
+    stats.roadsApplied += pendingRoads.size();
+    stats.totalApplyMs += applyMs;
+    stats.maxApplyMs = std::max(stats.maxApplyMs, applyMs);
+    stats.totalLatencyMs += latencyMs;
+    stats.maxLatencyMs = std::max(stats.maxLatencyMs, latencyMs);
+    pendingRoads.clear();
+}
+
+// ================ Metrics ================ //
+TrafficStreamStats TrafficStream::getStats() const {
+    std::lock_guard<std::mutex> guard(statsMutex);
+    TrafficStreamStats snapshot = stats;
+    snapshot.elapsedSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    return snapshot;
+}
+
+void TrafficStream::printStatistics() const {
+    TrafficStreamStats current = getStats();
+    double batches = std::max<long long>(1, current.batches);
+    std::ios savedFormat(nullptr);
+    savedFormat.copyfmt(std::cout);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Traffic Stream Statistics:\n";
+    std::cout << "  Updates: " << current.updatesAccepted << " accepted, " << current.coalesced
+              << " coalesced, " << current.rejected << " rejected\n";
+    std::cout << "  Batches: " << current.batches << " (" << current.roadsApplied << " road weights applied)\n";
+    std::cout << "  Throughput: " << std::setprecision(0) << current.updatesPerSecond()
+              << " updates/s" << std::setprecision(2) << "\n";
+    std::cout << "  Apply (lock held): avg " << current.totalApplyMs / batches << " ms, max "
+              << current.maxApplyMs << " ms\n";
+    std::cout << "  Latency (received -> applied): avg " << current.totalLatencyMs / batches
+              << " ms, max " << current.maxLatencyMs << " ms\n";
+    std::cout.copyfmt(savedFormat);
+}
@@ -1,175 +1,409 @@
 #include "Utils.hpp"
+#include "CsvReader.hpp"
+#include "ThreadPool.hpp"
+#include "CitySnapshot.hpp"
+#include <cctype>
+#include <charconv>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 
 // ================ File Loading Functions ================ //
 std::vector<std::string> FileUtils::parseCSVLine(const std::string& line) {
     std::vector<std::string> tokens;
-    std::stringstream ss(line);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        // Trim whitespace from token
-        size_t start = token.find_first_not_of(" \t\r\n");
-        size_t end = token.find_last_not_of(" \t\r\n");
-        if (start != std::string::npos && end != std::string::npos) {
-            tokens.push_back(token.substr(start, end - start + 1));
-        } else if (start == std::string::npos) {
-            tokens.push_back("");  // Empty field
-        } else {
-            tokens.push_back(token.substr(start, end - start + 1));
-        }
+    std::vector<std::string_view> fields;
+    CsvReader reader(line);
+    if (reader.nextRow(fields)) {
+        tokens.assign(fields.begin(), fields.end());
     }
     return tokens;
 }
 
-std::vector<Edge> FileUtils::loadCityMap() {
-    std::vector<Edge> edges;
-    std::ifstream file("Data/City_map.csv");
-    if (!file.is_open()) {
-        std::cerr << "Error opening City_map.csv" << std::endl;
-        return edges;
-    }
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        auto tokens = parseCSVLine(line);
-        if (tokens.size() >= 5) {
-            Edge edge;
-            try {
-                edge.source = tokens[0];
-                edge.destination = tokens[1];
-                edge.distance = std::stod(tokens[2]);
-                edge.traffic_congestion = std::stod(tokens[3]);
-                edge.traffic_time = std::stod(tokens[4]);
-                edges.push_back(edge);
-            } catch (const std::exception& e) {
-                std::cerr << "Error parsing city map line: " << line << std::endl;
-            }
+namespace {
+
+typedef std::vector<std::string_view> Fields;
+
+const char* const CITY_MAP_FILE = "Data/City_map.csv";
+const char* const LOCATIONS_FILE = "Data/locations.csv";
+const char* const VEHICLES_FILE = "Data/vehicles.csv";
+const char* const DELIVERIES_FILE = "Data/deliveries.csv";
+const char* const TRAFFIC_FILE = "Data/Traffic_updates.csv";
+
+// Rows parsed from one slice of a file, kept apart until the merge
+template<typename T>
+struct ParsedChunk {
+    std::vector<T> rows;
+    std::vector<std::string> malformed;   // raw text of rows that failed to parse
+    long long rowCount = 0;               // rows in the slice, kept or not
+};
+
+// Parse every row of a slice that starts on a row boundary
+template<typename T, typename Parser>
+void parseChunk(std::string_view text, size_t minFields, Parser parseRow, ParsedChunk<T>& chunk) {
+    chunk.rows.reserve(CsvReader::countRows(text));
+    CsvReader reader(text);
+    Fields fields;
+    while (reader.nextRow(fields)) {
+        if (fields.size() < minFields) continue;
+        T row;
+        if (parseRow(fields, row)) {
+            // Roads are numbered by their data row, so a skipped row shifts nothing
+            if constexpr (std::is_same<T, Edge>::value) row.road_id = static_cast<int>(reader.lineNumber());
+            chunk.rows.push_back(std::move(row));
+        } else {
+            chunk.malformed.emplace_back(reader.line());
         }
     }
-    return edges;
+    chunk.rowCount = reader.lineNumber();
 }
 
-std::vector<Location> FileUtils::loadLocations() {
-    std::vector<Location> locations;
-    std::ifstream file("Data/locations.csv");
-
-    if (!file.is_open()) {
-        std::cerr << "Error opening locations.csv" << std::endl;
-        return locations;
-    }   
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        auto tokens = parseCSVLine(line);
-        if (tokens.size() >= 4) {
-            Location location;
-            try {
-                location.id = std::stoi(tokens[0]);
-                location.name = tokens[1];
-                location.latitude = std::stod(tokens[2]);
-                location.longitude = std::stod(tokens[3]);
-                location.details = (tokens.size() > 4) ? tokens[4] : "";
-                locations.push_back(location);
-            } catch (const std::exception& e) {
-                std::cerr << "Error parsing location line: " << line << std::endl;
-            }
+// Map a data file and parse every row after the header with parseRow.
+// Rows with too few fields are skipped, rows that fail to parse reported.
+// With a pool the body is cut into slices at line breaks, parsed on the
+// workers and concatenated in file order.
+template<typename T, typename Parser>
+std::vector<T> loadTable(const std::string& path, const char* what, size_t minFields, Parser parseRow,
+                         ThreadPool* pool = nullptr) {
+    std::vector<T> rows;
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Error opening " << path.substr(path.find_last_of('/') + 1) << std::endl;
+        return rows;
+    }
+    
+    // Skip the header row
+    std::string_view body = file.data();
+    size_t headerEnd = body.find('\n');
+    body = (headerEnd == std::string_view::npos) ? std::string_view() : body.substr(headerEnd + 1);
+    
+    // A few slices per worker for balance, but none smaller than ~1 MB
+    const size_t minChunkBytes = 1 << 20;
+    size_t chunkCount = 1;
+    if (pool) {
+        chunkCount = std::max<size_t>(1, std::min<size_t>(4 * pool->size(), body.size() / minChunkBytes));
+    }
+    std::vector<size_t> bounds{0};
+    for (size_t k = 1; k < chunkCount; k++) {
+        size_t cut = std::max(bounds.back(), body.size() * k / chunkCount);
+        size_t newline = body.find('\n', cut);
+        if (newline == std::string_view::npos) break;
+        if (newline + 1 > bounds.back()) bounds.push_back(newline + 1);
+    }
+    bounds.push_back(body.size());
+    
+    std::vector<ParsedChunk<T>> chunks(bounds.size() - 1);
+    auto parseSlice = [&](int, size_t c) {
+        parseChunk(body.substr(bounds[c], bounds[c + 1] - bounds[c]), minFields, parseRow, chunks[c]);
+    };
+    if (pool && chunks.size() > 1) {
+        pool->parallelFor(chunks.size(), parseSlice);
+    } else {
+        for (size_t c = 0; c < chunks.size(); c++) parseSlice(0, c);
+    }
+    
+    // Concatenate in file order; malformed rows are reported per slice
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.rows.size();
+    rows.reserve(total);
+    long long rowsBefore = 0;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        if constexpr (std::is_same<T, Edge>::value) {
+            for (auto& row : chunks[c].rows) row.road_id += static_cast<int>(rowsBefore);
+        }
+        rowsBefore += chunks[c].rowCount;
+        for (const auto& line : chunks[c].malformed) {
+            std::cerr << "Error parsing " << what << " line: " << line << std::endl;
+        }
+        if (chunks.size() > 1 && !chunks[c].malformed.empty()) {
+            std::cerr << "  (" << chunks[c].malformed.size() << " malformed in chunk " << c + 1
+                      << "/" << chunks.size() << " of " << path << ")" << std::endl;
         }
+        std::move(chunks[c].rows.begin(), chunks[c].rows.end(), std::back_inserter(rows));
+        std::vector<T>().swap(chunks[c].rows);
     }
-    return locations;
+    return rows;
+}
+
+bool parseEdge(const Fields& tokens, Edge& edge) {
+    edge.source = std::string(tokens[0]);
+    edge.destination = std::string(tokens[1]);
+    return CsvReader::parseDouble(tokens[2], edge.distance) &&
+           CsvReader::parseDouble(tokens[3], edge.traffic_congestion) &&
+           CsvReader::parseDouble(tokens[4], edge.traffic_time);
+}
+
+bool parseLocation(const Fields& tokens, Location& location) {
+    location.name = std::string(tokens[1]);
+    location.details = (tokens.size() > 4) ? std::string(tokens[4]) : "";
+    return CsvReader::parseInt(tokens[0], location.id) &&
+           CsvReader::parseDouble(tokens[2], location.latitude) &&
+           CsvReader::parseDouble(tokens[3], location.longitude);
+}
+
+bool parseVehicle(const Fields& tokens, Vehicle& vehicle) {
+    // Numeric part of the vehicle ID (e.g. "V001" -> 1), 0 if there is none
+    std::string_view idText = tokens[0];
+    size_t pos = 0;
+    while (pos < idText.size() && !std::isdigit(static_cast<unsigned char>(idText[pos]))) pos++;
+    vehicle.id = 0;
+    if (pos < idText.size()) {
+        std::from_chars(idText.data() + pos, idText.data() + idText.size(), vehicle.id);
+    }
+    vehicle.type = std::string(tokens[2]);          // avg_speed_kmh can be stored as type for now
+    vehicle.licensePlate = std::string(tokens[3]);  // start_location stored as licensePlate
+    vehicle.status = "Active";
+    return CsvReader::parseDouble(tokens[1], vehicle.capacity);
+}
+
+bool parseDelivery(const Fields& tokens, Delivery& delivery) {
+    delivery.id = std::string(tokens[0]);
+    delivery.source = std::string(tokens[1]);
+    delivery.destination = std::string(tokens[2]);
+    delivery.deadline = std::string(tokens[3]);
+    delivery.priority = std::string(tokens[4]);
+    delivery.weight = 0.0;
+    FileUtils::parseSchedule(delivery);
+    return tokens.size() <= 5 || tokens[5].empty() || CsvReader::parseDouble(tokens[5], delivery.weight);
+}
+
+bool parseTrafficEvent(const Fields& tokens, TrafficEvent& event) {
+    event.timestamp = std::string(tokens[2]);
+    return CsvReader::parseInt(tokens[0], event.road_id) &&
+           CsvReader::parseInt(tokens[1], event.new_weight);
+}
+
+}  // namespace
+
+std::vector<std::string> FileUtils::dataFiles() {
+    return {CITY_MAP_FILE, LOCATIONS_FILE, VEHICLES_FILE, DELIVERIES_FILE, TRAFFIC_FILE};
+}
+
+std::vector<Edge> FileUtils::loadCityMap() {
+    return loadTable<Edge>(CITY_MAP_FILE, "city map", 5, parseEdge);
+}
+
+std::vector<Location> FileUtils::loadLocations() {
+    return loadTable<Location>(LOCATIONS_FILE, "location", 4, parseLocation);
 }
 
 std::vector<Vehicle> FileUtils::loadVehicles() {
-    std::vector<Vehicle> vehicles;
-    std::ifstream file("Data/vehicles.csv");
-    if (!file.is_open()) {
-        std::cerr << "Error opening vehicles.csv" << std::endl;
-        return vehicles;
-    }   
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        auto tokens = parseCSVLine(line);
-        if (tokens.size() >= 4) {
-            Vehicle vehicle;
-            try {
-                // Parse vehicle_id (e.g., "V001")
-                std::string id_str = tokens[0];
-                // Extract numeric part from vehicle ID
-                size_t pos = 0;
-                while (pos < id_str.size() && !std::isdigit(id_str[pos])) pos++;
-                if (pos < id_str.size()) {
-                    vehicle.id = std::stoi(id_str.substr(pos));
-                } else {
-                    vehicle.id = 0;
-                }
-                vehicle.capacity = std::stod(tokens[1]);
-                vehicle.type = tokens[2];  // avg_speed_kmh can be stored as type for now
-                vehicle.licensePlate = tokens[3];  // start_location stored as licensePlate
-                vehicle.status = "Active";
-                vehicles.push_back(vehicle);
-            } catch (const std::exception& e) {
-                std::cerr << "Error parsing vehicle line: " << line << std::endl;
-            }
-        }
+    return loadTable<Vehicle>(VEHICLES_FILE, "vehicle", 4, parseVehicle);
+}
+
+std::vector<Delivery> FileUtils::loadDeliveries(ThreadPool* pool) {
+    return loadTable<Delivery>(DELIVERIES_FILE, "delivery", 5, parseDelivery, pool);
+}
+
+std::vector<TrafficEvent> FileUtils::loadTrafficUpdates(ThreadPool* pool) {
+    return loadTable<TrafficEvent>(TRAFFIC_FILE, "traffic event", 3, parseTrafficEvent, pool);
+}
+
+// ================ Location Index ================ //
+void LocationIndex::build(const std::vector<Location>& locations) {
+    clear();
+    ids.reserve(locations.size());
+    names.reserve(locations.size());
+    for (const auto& loc : locations) {
+        int index = add(loc.id);
+        if (names[index].empty()) names[index] = loc.name;
+    }
+    rebuildNameSlots();
+}
+
+int LocationIndex::add(int locationId) {
+    auto [it, inserted] = indices.emplace(locationId, static_cast<int>(ids.size()));
+    if (inserted) {
+        ids.push_back(locationId);
+        names.emplace_back();
+    }
+    return it->second;
+}
+
+void LocationIndex::rebuildNameSlots() {
+    size_t capacity = 16;
+    while (capacity < 2 * names.size()) capacity <<= 1;
+    nameSlots.assign(capacity, -1);
+    for (size_t i = 0; i < names.size(); i++) {
+        internName(static_cast<int>(i));
     }
-    return vehicles;
-}
-
-std::vector<Delivery> FileUtils::loadDeliveries() {
-    std::vector<Delivery> deliveries;
-    std::ifstream file("Data/deliveries.csv");
-    if (!file.is_open()) {
-        std::cerr << "Error opening deliveries.csv" << std::endl;
-        return deliveries;
-    }   
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        auto tokens = parseCSVLine(line);
-        if (tokens.size() >= 5) {
-            Delivery delivery;
-            try {
-                delivery.id = tokens[0];
-                delivery.source = tokens[1];
-                delivery.destination = tokens[2];
-                delivery.deadline = tokens[3];
-                delivery.priority = tokens[4];
-                delivery.weight = (tokens.size() > 5 && !tokens[5].empty()) ? std::stod(tokens[5]) : 0.0;
-                deliveries.push_back(delivery);
-            } catch (const std::exception& e) {
-                std::cerr << "Error parsing delivery line: " << line << std::endl;
-            }
+}
+
+void LocationIndex::internName(int index) {
+    const std::string& name = names[index];
+    if (name.empty()) return;
+    size_t mask = nameSlots.size() - 1;
+    for (size_t slot = std::hash<std::string_view>()(name) & mask; ; slot = (slot + 1) & mask) {
+        if (nameSlots[slot] == -1) {
+            nameSlots[slot] = index;
+            return;
         }
+        if (names[nameSlots[slot]] == name) return;   // keep the first location
+    }
+}
+
+int LocationIndex::indexOfName(std::string_view name) const {
+    if (nameSlots.empty() || name.empty()) return -1;
+    size_t mask = nameSlots.size() - 1;
+    for (size_t slot = std::hash<std::string_view>()(name) & mask; nameSlots[slot] != -1;
+         slot = (slot + 1) & mask) {
+        if (names[nameSlots[slot]] == name) return nameSlots[slot];
+    }
+    return -1;
+}
+
+int LocationIndex::idOfName(std::string_view name) const {
+    int index = indexOfName(name);
+    return index == -1 ? -1 : ids[index];
+}
+
+void LocationIndex::resolve(std::vector<Edge>& edges) const {
+    for (auto& edge : edges) {
+        edge.sourceId = idOfName(edge.source);
+        edge.destinationId = idOfName(edge.destination);
+    }
+}
+
+void LocationIndex::resolve(std::vector<Delivery>& deliveries) const {
+    for (auto& delivery : deliveries) {
+        delivery.sourceId = idOfName(delivery.source);
+        delivery.destinationId = idOfName(delivery.destination);
+    }
+}
+
+int LocationIndex::toIndex(int locationId) const {
+    auto it = indices.find(locationId);
+    return it == indices.end() ? -1 : it->second;
+}
+
+int LocationIndex::toId(int index) const {
+    if (index < 0 || index >= static_cast<int>(ids.size())) return -1;
+    return ids[index];
+}
+
+int LocationIndex::size() const {
+    return static_cast<int>(ids.size());
+}
+
+void LocationIndex::clear() {
+    ids.clear();
+    indices.clear();
+    names.clear();
+    nameSlots.clear();
+}
+
+void LocationIndex::writeSnapshot(SnapshotWriter& writer) const {
+    std::vector<StrRef> nameRefs;
+    nameRefs.reserve(names.size());
+    for (const auto& name : names) nameRefs.push_back(writer.addString(name));
+    writer.addArray(SnapshotSection::IndexIds, ids);
+    writer.addArray(SnapshotSection::IndexNames, nameRefs);
+    writer.addArray(SnapshotSection::IndexNameSlots, nameSlots);
+}
+
+bool LocationIndex::readSnapshot(const SnapshotReader& reader) {
+    std::vector<int> loadedIds, loadedSlots;
+    std::vector<StrRef> nameRefs;
+    if (!reader.readArray(SnapshotSection::IndexIds, loadedIds) ||
+        !reader.readArray(SnapshotSection::IndexNames, nameRefs) ||
+        !reader.readArray(SnapshotSection::IndexNameSlots, loadedSlots) ||
+        nameRefs.size() != loadedIds.size()) {
+        return false;
+    }
+    // The probe table must be a power of two and point at valid indices
+    size_t capacity = loadedSlots.size();
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    for (int slot : loadedSlots) {
+        if (slot < -1 || slot >= static_cast<int>(loadedIds.size())) return false;
     }
-    return deliveries;
-}
-
-std::vector<TrafficEvent> FileUtils::loadTrafficUpdates() {
-    std::vector<TrafficEvent> events;
-    std::ifstream file("Data/Traffic_updates.csv");
-    if (!file.is_open()) {
-        std::cerr << "Error opening Traffic_updates.csv" << std::endl;
-        return events;
-    }   
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        auto tokens = parseCSVLine(line);
-        if (tokens.size() >= 3) {
-            TrafficEvent event;
-            try {
-                event.road_id = std::stoi(tokens[0]);
-                event.new_weight = std::stoi(tokens[1]);
-                event.timestamp = tokens[2];
-                events.push_back(event);
-            } catch (const std::exception& e) {
-                std::cerr << "Error parsing traffic event line: " << line << std::endl;
-            }
+
+    clear();
+    names.resize(nameRefs.size());
+    indices.reserve(loadedIds.size());
+    for (size_t i = 0; i < loadedIds.size(); i++) {
+        if (!reader.string(nameRefs[i], names[i]) ||
+            !indices.emplace(loadedIds[i], static_cast<int>(i)).second) {
+            clear();
+            return false;
         }
     }
-    return events;
+    ids.swap(loadedIds);
+    nameSlots.swap(loadedSlots);
+    return true;
 }
 
 // ================ Calculate Distance Function ================ //
 double FileUtils::calculateDistance(double x1, double y1, double x2, double y2) {
     return std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
-}
\ No newline at end of file
+}
+
+// ================ Great-Circle Distance Function ================ //
+double FileUtils::greatCircleDistance(double lat1, double lon1, double lat2, double lon2) {
+    const double earthRadiusKm = 6371.0;
+    const double toRad = 3.14159265358979323846 / 180.0;
+    double dLat = (lat2 - lat1) * toRad;
+    double dLon = (lon2 - lon1) * toRad;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(lat1 * toRad) * std::cos(lat2 * toRad) *
+               std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * earthRadiusKm * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+// ================ Timestamp Parsing ================ //
+long long FileUtils::parseTimestamp(std::string_view timestamp) {
+    // Hand-rolled scan (runs once per loaded delivery / traffic row):
+    // 1..maxDigits digits at pos, then an optional expected separator
+    size_t pos = 0;
+    auto number = [&](int maxDigits, int& value) {
+        size_t start = pos;
+        value = 0;
+        while (pos < timestamp.size() && pos - start < static_cast<size_t>(maxDigits) &&
+               timestamp[pos] >= '0' && timestamp[pos] <= '9') {
+            value = value * 10 + (timestamp[pos++] - '0');
+        }
+        return pos > start;
+    };
+    auto separator = [&](char expected) {
+        if (pos < timestamp.size() && timestamp[pos] == expected) {
+            pos++;
+            return true;
+        }
+        return false;
+    };
+    
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (!number(4, year) || !separator('-') || !number(2, month) || !separator('-') ||
+        !number(2, day)) {
+        return -1;
+    }
+    // Optional time of day, seconds optional within it
+    if (pos < timestamp.size()) {
+        if (!separator('T') && !separator(' ')) return -1;
+        if (!number(2, hour) || !separator(':') || !number(2, minute)) return -1;
+        if (separator(':') && !number(2, second)) return -1;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar (days-from-civil)
+    long long y = year - (month <= 2 ? 1 : 0);
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yearOfEra = y - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    long long days = era * 146097 + dayOfEra - 719468;
+
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+PriorityLevel FileUtils::parsePriority(const std::string& priority) {
+    if (priority == "High") return PriorityLevel::High;
+    if (priority == "Medium") return PriorityLevel::Medium;
+    return PriorityLevel::Low;
+}
+
+void FileUtils::parseSchedule(Delivery& delivery) {
+    delivery.level = parsePriority(delivery.priority);
+    delivery.deadlineEpoch = parseTimestamp(delivery.deadline);
+}